@@ -0,0 +1,96 @@
+// 捕获文件格式：网络请求/响应、Lua chunk、evalString 源码写入同一个 append-only 文件
+// 设备端（jni/main.cpp）与主机端读取工具（tools/fgcap_read.cpp）共用，只依赖标准库
+//
+//   CaptureFileHeader
+//   块 * N            CaptureBlockHeader + zlib 压缩数据（解压后为连续的记录）
+//   CaptureIndexEntry * N
+//   CaptureTrailer
+//
+// 记录：CaptureRecordHeader + 名称 + 内容。写入端每刷新一个块，就把索引和 Trailer 重写到该块之后，
+// 读取端按索引二分定位记录所在块，只解压这一块。进程被杀导致 Trailer 无效时，按块头顺序扫描即可恢复。
+// 所有字段为小端，结构体按自然对齐排布且无填充。
+
+#pragma once
+
+#include <cstdint>
+#include <cstddef>
+#include <cstring>
+
+static constexpr uint32_t kCaptureFileMagic = 0x50434746;     // "FGCP"
+static constexpr uint32_t kCaptureBlockMagic = 0x42434746;    // "FGCB"
+static constexpr uint32_t kCaptureTrailerMagic = 0x49434746;  // "FGCI"
+static constexpr uint16_t kCaptureVersion = 1;
+
+enum CaptureKind : uint8_t {
+    CAPTURE_HTTP_REQUEST = 1,       // 名称 "id=<请求ID> op=<操作类型>"，内容为三个字符串参数，以 '\0' 分隔
+    CAPTURE_HTTP_RESPONSE = 2,      // 名称 "code=<响应码>"，内容为原始响应
+    CAPTURE_LUA_CHUNK = 3,          // 名称 "<内容 XXH64 十六进制> <chunk 名>"，内容为 luaL_loadbufferx 的缓冲区；同一进程内相同内容只写一次
+    CAPTURE_EVAL_STRING = 4,        // 名称为脚本路径，内容为 JS 源码
+};
+
+struct CaptureFileHeader {
+    uint32_t magic;
+    uint16_t version;
+    uint16_t reserved;
+};
+
+struct CaptureBlockHeader {
+    uint32_t magic;
+    uint32_t compressed_size;
+    uint32_t uncompressed_size;
+    uint32_t record_count;
+    uint64_t first_record;          // 块内第一条记录的全局序号
+    uint32_t crc32;                 // 解压后数据的 CRC32
+    uint32_t reserved;
+};
+
+struct CaptureRecordHeader {
+    uint8_t kind;
+    uint8_t reserved;
+    uint16_t name_length;
+    uint32_t payload_length;
+    uint64_t timestamp_ns;          // CLOCK_REALTIME
+};
+
+struct CaptureIndexEntry {
+    uint64_t offset;                // 块头在文件中的偏移
+    uint64_t first_record;
+    uint32_t record_count;
+    uint32_t reserved;
+};
+
+struct CaptureTrailer {
+    uint64_t index_offset;
+    uint32_t block_count;
+    uint32_t magic;
+};
+
+static_assert(sizeof(CaptureFileHeader) == 8, "CaptureFileHeader 布局");
+static_assert(sizeof(CaptureBlockHeader) == 32, "CaptureBlockHeader 布局");
+static_assert(sizeof(CaptureRecordHeader) == 16, "CaptureRecordHeader 布局");
+static_assert(sizeof(CaptureIndexEntry) == 24, "CaptureIndexEntry 布局");
+static_assert(sizeof(CaptureTrailer) == 16, "CaptureTrailer 布局");
+
+// 解压后的块内记录视图
+struct CaptureRecordView {
+    CaptureRecordHeader header;
+    const char* name;
+    const uint8_t* payload;
+};
+
+// 从块数据的 *offset 处读取一条记录，数据不完整时返回 false
+inline bool nextCaptureRecord(const uint8_t* block, size_t size, size_t* offset, CaptureRecordView* record) {
+    if (*offset > size || size - *offset < sizeof(CaptureRecordHeader)) {
+        return false;
+    }
+    memcpy(&record->header, block + *offset, sizeof(CaptureRecordHeader));
+    size_t body = size_t(record->header.name_length) + record->header.payload_length;
+    size_t begin = *offset + sizeof(CaptureRecordHeader);
+    if (size - begin < body) {
+        return false;
+    }
+    record->name = reinterpret_cast<const char*>(block + begin);
+    record->payload = block + begin + record->header.name_length;
+    *offset = begin + body;
+    return true;
+}
@@ -0,0 +1,97 @@
+// 库目录扫描：列出目录中的 .so 及其大小与 ELF 元数据
+// 设备端（jni/main.cpp）与主机端基准工具（tools/bench_libscan.cpp）共用，只依赖标准库与 POSIX
+
+#pragma once
+
+#include <cstdint>
+#include <cstddef>
+#include <cstring>
+#include <algorithm>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include <dirent.h>
+#include <elf.h>
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+// 库文件信息
+struct LibraryInfo {
+    std::string name;
+    size_t size;
+    uint16_t e_machine = 0;       // ELF 机器类型（EM_AARCH64 等），非 ELF 为 0
+    uint16_t section_count = 0;   // 节区数量
+    bool has_dynsym = false;      // 是否包含 .dynsym
+    uint64_t apk_offset = 0;      // 来自 APK 时：数据在 base.apk 中的偏移（0 表示已解压到库目录）
+    bool apk_stored = false;      // 来自 APK 时：未压缩存放
+    bool apk_page_aligned = false; // 未压缩且偏移按页对齐（可直接从 APK 映射）
+};
+
+// 读取 ELF 头与节区头表，填充机器类型 / 节区数量 / 是否有 .dynsym（base 为 ELF 在文件中的偏移）
+inline void readElfMetadata(int fd, LibraryInfo& info, off_t base = 0) {
+    Elf64_Ehdr ehdr;
+    if (pread(fd, &ehdr, sizeof(ehdr), base) != (ssize_t)sizeof(ehdr) ||
+        memcmp(ehdr.e_ident, ELFMAG, SELFMAG) != 0 ||
+        ehdr.e_ident[EI_CLASS] != ELFCLASS64) {
+        return;
+    }
+
+    info.e_machine = ehdr.e_machine;
+    info.section_count = ehdr.e_shnum;
+
+    if (ehdr.e_shnum == 0 || ehdr.e_shentsize != sizeof(Elf64_Shdr)) {
+        return;
+    }
+
+    std::vector<Elf64_Shdr> sections(ehdr.e_shnum);
+    size_t table_size = sections.size() * sizeof(Elf64_Shdr);
+    if (pread(fd, sections.data(), table_size, base + ehdr.e_shoff) != (ssize_t)table_size) {
+        return;
+    }
+
+    info.has_dynsym = std::any_of(sections.begin(), sections.end(),
+        [](const Elf64_Shdr& sh) { return sh.sh_type == SHT_DYNSYM; });
+}
+
+// 直接扫描库目录（opendir + fstatat），不经过 shell；目录无法打开时返回 false（errno 保留）
+inline bool scanLibraryDirectory(const std::string& lib_dir, std::vector<LibraryInfo>* result) {
+    result->clear();
+
+    DIR* dir = opendir(lib_dir.c_str());
+    if (!dir) {
+        return false;
+    }
+
+    int dir_fd = dirfd(dir);
+    while (dirent* entry = readdir(dir)) {
+        std::string_view name(entry->d_name);
+        if (name.size() <= 3 || name.substr(name.size() - 3) != ".so") {
+            continue;
+        }
+        if (entry->d_type != DT_REG && entry->d_type != DT_LNK && entry->d_type != DT_UNKNOWN) {
+            continue;
+        }
+
+        struct stat st;
+        if (fstatat(dir_fd, entry->d_name, &st, 0) != 0 || !S_ISREG(st.st_mode)) {
+            continue;
+        }
+
+        LibraryInfo info;
+        info.name.assign(name);
+        info.size = static_cast<size_t>(st.st_size);
+
+        int fd = openat(dir_fd, entry->d_name, O_RDONLY | O_CLOEXEC);
+        if (fd >= 0) {
+            readElfMetadata(fd, info);
+            close(fd);
+        }
+
+        result->push_back(std::move(info));
+    }
+
+    closedir(dir);
+    return true;
+}
@@ -0,0 +1,224 @@
+// 日志记录的参数编码与二进制日志文件格式
+// 设备端（jni/main.cpp）与主机端解码工具（tools/fglog_decode.cpp）共用，只依赖标准库
+
+#pragma once
+
+#include <cstdint>
+#include <cstddef>
+#include <cstdio>
+#include <cstring>
+#include <algorithm>
+
+// 单条记录上限，与 logd 单行上限相当
+static constexpr size_t kLogMaxRecordSize = 4096;
+
+// 记录中参数的类型标签
+enum LogArgTag : uint8_t {
+    LOG_ARG_INT,            // int64_t
+    LOG_ARG_UINT,           // uint64_t
+    LOG_ARG_DOUBLE,         // double
+    LOG_ARG_POINTER,        // uint64_t
+    LOG_ARG_STRING,         // 原指针 uint64_t + 长度 uint16_t + 内容 + '\0'
+    LOG_ARG_NULL_STRING,    // 无负载
+};
+
+// ============================
+// 二进制日志文件（FG_LOG_BINARY）
+// ============================
+// 文件头之后是连续的条目，每个条目以 1 字节类型开头，多字节字段均为小端、无对齐：
+//   LOG_ENTRY_FORMAT:  uint32 id, uint16 长度, 格式串内容（无 '\0'）
+//   LOG_ENTRY_RECORD:  uint32 格式串 id, uint8 级别, uint32 tid, uint64 时间戳(ns), uint16 参数长度, 参数
+//   LOG_ENTRY_DROPPED: uint32 tid, uint64 丢弃条数
+// 格式串在首次出现时以 FORMAT 条目定义，之后的记录只引用其 id。
+
+static constexpr uint32_t kLogFileMagic = 0x424c4746;  // "FGLB"
+static constexpr uint16_t kLogFileVersion = 1;
+
+struct LogFileHeader {
+    uint32_t magic;
+    uint16_t version;
+    uint16_t reserved;
+    uint64_t realtime_ns;       // 打开文件时的 CLOCK_REALTIME
+    uint64_t monotonic_ns;      // 同一时刻的 CLOCK_MONOTONIC，记录时间戳以此为基准换算
+};
+
+enum LogEntryType : uint8_t {
+    LOG_ENTRY_FORMAT = 1,
+    LOG_ENTRY_RECORD = 2,
+    LOG_ENTRY_DROPPED = 3,
+};
+
+// 顺序读取记录中的参数
+class LogArgReader {
+public:
+    LogArgReader(const uint8_t* begin, const uint8_t* end) : pos_(begin), end_(end) {}
+    
+    bool next(LogArgTag& tag, uint64_t& bits, const char*& str) {
+        if (pos_ >= end_) return false;
+        tag = static_cast<LogArgTag>(*pos_++);
+        if (tag == LOG_ARG_NULL_STRING) {
+            bits = 0;
+            str = "(null)";
+            return true;
+        }
+        if (tag > LOG_ARG_NULL_STRING || end_ - pos_ < static_cast<ptrdiff_t>(sizeof(bits))) {
+            pos_ = end_;
+            return false;
+        }
+        memcpy(&bits, pos_, sizeof(bits));
+        pos_ += sizeof(bits);
+        if (tag == LOG_ARG_STRING) {
+            uint16_t length;
+            if (end_ - pos_ < static_cast<ptrdiff_t>(sizeof(length))) {
+                pos_ = end_;
+                return false;
+            }
+            memcpy(&length, pos_, sizeof(length));
+            pos_ += sizeof(length);
+            if (end_ - pos_ < length + 1 || pos_[length] != '\0') {
+                pos_ = end_;
+                return false;
+            }
+            str = reinterpret_cast<const char*>(pos_);
+            pos_ += length + 1;
+        }
+        return true;
+    }
+    
+private:
+    const uint8_t* pos_;
+    const uint8_t* end_;
+};
+
+// 按格式串还原文本：逐个转换说明调用 snprintf，参数按说明符的类型取用；
+// 类型与说明符不符或参数缺失时输出 <?>
+inline size_t formatLogArgs(const char* format, const uint8_t* args_begin, const uint8_t* args_end,
+                            char* out, size_t capacity) {
+    LogArgReader args(args_begin, args_end);
+    const char* f = format;
+    size_t pos = 0;
+    
+    auto append = [&](const char* text, size_t length) {
+        length = std::min(length, capacity - 1 - pos);
+        memcpy(out + pos, text, length);
+        pos += length;
+    };
+    auto nextInt = [&]() -> int {
+        LogArgTag tag;
+        uint64_t bits = 0;
+        const char* str;
+        args.next(tag, bits, str);
+        return static_cast<int>(bits);
+    };
+    
+    while (*f && pos < capacity - 1) {
+        if (*f != '%') {
+            const char* next = strchr(f, '%');
+            size_t length = next ? size_t(next - f) : strlen(f);
+            append(f, length);
+            f += length;
+            continue;
+        }
+        if (f[1] == '%') {
+            append("%", 1);
+            f += 2;
+            continue;
+        }
+        
+        // 重建转换说明：'*' 替换为实际数值，长度修饰统一为 ll（值已按原长度截断）
+        char spec[64];
+        size_t spec_len = 0;
+        spec[spec_len++] = *f++;
+        while (*f && strchr("-+ #0", *f) && spec_len < 16) spec[spec_len++] = *f++;
+        for (int part = 0; part < 2; part++) {
+            if (part == 1) {
+                if (*f != '.') break;
+                spec[spec_len++] = *f++;
+            }
+            if (*f == '*') {
+                spec_len += snprintf(spec + spec_len, 12, "%d", nextInt());
+                f++;
+            } else {
+                while (*f >= '0' && *f <= '9' && spec_len < 40) spec[spec_len++] = *f++;
+            }
+        }
+        char length_mod[3] = {0, 0, 0};
+        for (int i = 0; i < 2 && *f && strchr("hljztLq", *f); i++) length_mod[i] = *f++;
+        char conversion = *f ? *f++ : '\0';
+        
+        if (conversion == '\0') {
+            break;
+        }
+        LogArgTag tag;
+        uint64_t bits = 0;
+        const char* str = nullptr;
+        if (!args.next(tag, bits, str)) {
+            append("<?>", 3);
+            continue;
+        }
+        
+        char piece[kLogMaxRecordSize];
+        int written = -1;
+        bool integer_arg = tag == LOG_ARG_INT || tag == LOG_ARG_UINT || tag == LOG_ARG_POINTER;
+        switch (conversion) {
+            case 'd': case 'i': case 'u': case 'o': case 'x': case 'X': {
+                if (!integer_arg) break;
+                // 按长度修饰截断后以 long long 输出
+                uint64_t value = bits;
+                bool is_signed = conversion == 'd' || conversion == 'i';
+                if (length_mod[0] == 'h' && length_mod[1] == 'h') {
+                    value = is_signed ? uint64_t(int64_t(int8_t(value))) : uint8_t(value);
+                } else if (length_mod[0] == 'h') {
+                    value = is_signed ? uint64_t(int64_t(int16_t(value))) : uint16_t(value);
+                } else if (length_mod[0] == '\0') {
+                    value = is_signed ? uint64_t(int64_t(int32_t(value))) : uint32_t(value);
+                }
+                spec[spec_len] = 'l';
+                spec[spec_len + 1] = 'l';
+                spec[spec_len + 2] = conversion;
+                spec[spec_len + 3] = '\0';
+                written = is_signed ? snprintf(piece, sizeof(piece), spec, (long long)value)
+                                    : snprintf(piece, sizeof(piece), spec, (unsigned long long)value);
+                break;
+            }
+            case 'c':
+                if (!integer_arg) break;
+                spec[spec_len] = 'c';
+                spec[spec_len + 1] = '\0';
+                written = snprintf(piece, sizeof(piece), spec, int(bits));
+                break;
+            case 'f': case 'F': case 'e': case 'E': case 'g': case 'G': case 'a': case 'A': {
+                if (tag != LOG_ARG_DOUBLE) break;
+                double value;
+                memcpy(&value, &bits, sizeof(value));
+                spec[spec_len] = conversion;
+                spec[spec_len + 1] = '\0';
+                written = snprintf(piece, sizeof(piece), spec, value);
+                break;
+            }
+            case 's':
+                if (tag != LOG_ARG_STRING && tag != LOG_ARG_NULL_STRING) break;
+                spec[spec_len] = 's';
+                spec[spec_len + 1] = '\0';
+                written = snprintf(piece, sizeof(piece), spec, str);
+                break;
+            case 'p':
+                if (tag == LOG_ARG_DOUBLE) break;
+                spec[spec_len] = 'p';
+                spec[spec_len + 1] = '\0';
+                written = snprintf(piece, sizeof(piece), spec, reinterpret_cast<void*>(uintptr_t(bits)));
+                break;
+            default:
+                break;
+        }
+        
+        if (written < 0) {
+            append("<?>", 3);
+        } else {
+            append(piece, std::min<size_t>(written, sizeof(piece) - 1));
+        }
+    }
+    
+    out[pos] = '\0';
+    return pos;
+}
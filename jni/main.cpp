@@ -1,345 +1,3148 @@
 #include <unistd.h>
+#include <fcntl.h>
+#include <dirent.h>
+#include <elf.h>
+#include <sys/stat.h>
+#include <sys/mman.h>
+#include <sys/file.h>
+#include <pthread.h>
+#include <sched.h>
 #include <android/log.h>
 #include <dlfcn.h>
+#include <cerrno>
 #include <string>
+#include <string_view>
 #include <unordered_map>
+#include <unordered_set>
 #include <fstream>
-#include <sstream>
 #include <vector>
 #include <algorithm>
+#include <array>
+#include <optional>
+#include <utility>
 #include <cstring>
 #include <cstdlib>
 #include <thread>
-#include <regex>
+#include <mutex>
+#include <condition_variable>
+#include <functional>
+#include <memory>
+#include <span>
+#include <type_traits>
+#include <atomic>
+#include <deque>
 #include <chrono>
 #include "frida-gum.h"
+#include "log_record.h"
+#include "capture_format.h"
+#include "xxh64.h"
+#include "maps_snapshot.h"
+#include "library_scan.h"
+#include "pattern_scan.h"
+#include <zlib.h>
 
 #define LOG_TAG "FridaGum"
-#define LOGI(...) __android_log_print(ANDROID_LOG_INFO, LOG_TAG, __VA_ARGS__)
-#define LOGE(...) __android_log_print(ANDROID_LOG_ERROR, LOG_TAG, __VA_ARGS__)
-#define LOGD(...) __android_log_print(ANDROID_LOG_DEBUG, LOG_TAG, __VA_ARGS__)
 
-// ⏱️ 计时器类 - 用于性能分析
-class Timer {
+// ============================
+// 异步日志
+// ============================
+// LOGI/LOGD/LOGE 在调用线程上只把格式串指针与原始参数编码为二进制记录，写入该线程独占的
+// 单生产者/单消费者环形缓冲；格式化和 logd 输出都在后台线程完成。
+// 缓冲区满时丢弃新记录并计数，不阻塞 Hook 所在的游戏线程。
+// 参数编码与二进制日志文件格式见 log_record.h。
+
+// 编译期日志级别：低于该级别的 LOG 宏不生成任何代码，参数也不会求值
+#ifndef FG_MIN_LOG_LEVEL
+#ifdef NDEBUG
+#define FG_MIN_LOG_LEVEL ANDROID_LOG_INFO
+#else
+#define FG_MIN_LOG_LEVEL ANDROID_LOG_DEBUG
+#endif
+#endif
+
+// 为 1 时日志写入二进制文件（格式串 id + 参数），由主机端 tools/fglog_decode 还原；
+// ERROR 级别同时输出到 logd
+#ifndef FG_LOG_BINARY
+#define FG_LOG_BINARY 0
+#endif
+
+template <int Priority>
+inline constexpr bool kLogLevelEnabled = Priority >= FG_MIN_LOG_LEVEL;
+
+// 记录头，后接参数；整条记录按 8 字节对齐
+struct LogRecordHeader {
+    uint32_t size;          // 含头部
+    uint8_t priority;       // 0 表示环尾的填充记录
+    uint8_t arg_count;
+    uint16_t reserved;
+    const char* format;     // 只允许字符串字面量（由宏保证）
+    uint64_t timestamp_ns;  // CLOCK_MONOTONIC，仅二进制日志使用
+};
+
+static inline uint64_t logTimestampNs(clockid_t clock) {
+    timespec ts;
+    clock_gettime(clock, &ts);
+    return uint64_t(ts.tv_sec) * 1000000000ull + uint64_t(ts.tv_nsec);
+}
+
+static constexpr size_t kLogRingCapacity = 128 * 1024;   // 每线程环形缓冲大小（2 的幂）
+
+// 单生产者/单消费者环形缓冲：生产者为所属线程，消费者为日志线程
+class LogRing {
+public:
+    // 生产者：空间不足时丢弃并计数
+    bool push(const uint8_t* record, size_t size) {
+        uint64_t head = head_.load(std::memory_order_relaxed);
+        size_t offset = head & (kLogRingCapacity - 1);
+        size_t contiguous = kLogRingCapacity - offset;
+        size_t needed = size > contiguous ? size + contiguous : size;
+        
+        if (head + needed - cached_tail_ > kLogRingCapacity) {
+            cached_tail_ = tail_.load(std::memory_order_acquire);
+            if (head + needed - cached_tail_ > kLogRingCapacity) {
+                dropped.store(dropped.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+                return false;
+            }
+        }
+        
+        if (size > contiguous) {
+            // 环尾放不下：写填充记录，从头开始（对齐保证剩余空间至少 8 字节）
+            LogRecordHeader* padding = reinterpret_cast<LogRecordHeader*>(buffer_ + offset);
+            padding->size = static_cast<uint32_t>(contiguous);
+            padding->priority = 0;
+            head += contiguous;
+            offset = 0;
+        }
+        memcpy(buffer_ + offset, record, size);
+        head_.store(head + size, std::memory_order_release);
+        return true;
+    }
+    
+    // 消费者：逐条交给 consume，返回处理的记录数
+    template <typename Consume>
+    size_t drain(Consume&& consume) {
+        uint64_t tail = tail_.load(std::memory_order_relaxed);
+        uint64_t head = head_.load(std::memory_order_acquire);
+        size_t count = 0;
+        while (tail != head) {
+            const uint8_t* record = buffer_ + (tail & (kLogRingCapacity - 1));
+            const LogRecordHeader* header = reinterpret_cast<const LogRecordHeader*>(record);
+            if (header->priority != 0) {
+                consume(record, header->size);
+                count++;
+            }
+            tail += header->size;
+        }
+        tail_.store(tail, std::memory_order_release);
+        return count;
+    }
+    
+    std::atomic<uint64_t> dropped{0};      // 生产者写
+    uint64_t dropped_reported = 0;         // 消费者写
+    std::atomic<bool> orphaned{false};     // 所属线程已退出，排空后回收复用
+    uint32_t tid = 0;                      // 所属线程
+    
+private:
+    alignas(64) std::atomic<uint64_t> head_{0};
+    uint64_t cached_tail_ = 0;             // 生产者缓存的 tail，减少跨核读取
+    alignas(64) std::atomic<uint64_t> tail_{0};
+    alignas(64) uint8_t buffer_[kLogRingCapacity];
+};
+
+// 在栈上缓冲区中编码一条记录，超出上限的字符串被截断
+class LogRecordWriter {
+public:
+    LogRecordWriter(uint8_t* buffer, size_t capacity)
+        : buffer_(buffer), capacity_(capacity), pos_(sizeof(LogRecordHeader)) {}
+    
+    void putScalar(LogArgTag tag, uint64_t bits) {
+        if (pos_ + 1 + sizeof(bits) > capacity_) return;
+        buffer_[pos_++] = tag;
+        memcpy(buffer_ + pos_, &bits, sizeof(bits));
+        pos_ += sizeof(bits);
+        count_++;
+    }
+    
+    void putString(const char* str) {
+        if (!str) {
+            if (pos_ + 1 > capacity_) return;
+            buffer_[pos_++] = LOG_ARG_NULL_STRING;
+            count_++;
+            return;
+        }
+        constexpr size_t overhead = 1 + sizeof(uint64_t) + sizeof(uint16_t) + 1;
+        if (pos_ + overhead > capacity_) return;
+        uint64_t address = reinterpret_cast<uintptr_t>(str);
+        uint16_t length = static_cast<uint16_t>(strnlen(str, capacity_ - pos_ - overhead));
+        buffer_[pos_++] = LOG_ARG_STRING;
+        memcpy(buffer_ + pos_, &address, sizeof(address));
+        pos_ += sizeof(address);
+        memcpy(buffer_ + pos_, &length, sizeof(length));
+        pos_ += sizeof(length);
+        memcpy(buffer_ + pos_, str, length);
+        pos_ += length;
+        buffer_[pos_++] = '\0';
+        count_++;
+    }
+    
+    // 填写记录头，返回对齐后的记录长度
+    size_t finish(int priority, const char* format) {
+        size_t size = (pos_ + 7) & ~size_t(7);
+        LogRecordHeader* header = reinterpret_cast<LogRecordHeader*>(buffer_);
+        header->size = static_cast<uint32_t>(size);
+        header->priority = static_cast<uint8_t>(priority);
+        header->arg_count = count_;
+        header->reserved = 0;
+        header->format = format;
+        header->timestamp_ns = FG_LOG_BINARY ? logTimestampNs(CLOCK_MONOTONIC) : 0;
+        return size;
+    }
+    
+private:
+    uint8_t* buffer_;
+    size_t capacity_;
+    size_t pos_;
+    uint8_t count_ = 0;
+};
+
+template <typename T>
+inline void encodeLogArg(LogRecordWriter& writer, T value) {
+    if constexpr (std::is_same_v<T, const char*> || std::is_same_v<T, char*>) {
+        writer.putString(value);
+    } else if constexpr (std::is_enum_v<T>) {
+        encodeLogArg(writer, static_cast<std::underlying_type_t<T>>(value));
+    } else if constexpr (std::is_integral_v<T> && std::is_signed_v<T>) {
+        writer.putScalar(LOG_ARG_INT, static_cast<uint64_t>(static_cast<int64_t>(value)));
+    } else if constexpr (std::is_integral_v<T>) {
+        writer.putScalar(LOG_ARG_UINT, static_cast<uint64_t>(value));
+    } else if constexpr (std::is_floating_point_v<T>) {
+        double d = static_cast<double>(value);
+        uint64_t bits;
+        memcpy(&bits, &d, sizeof(bits));
+        writer.putScalar(LOG_ARG_DOUBLE, bits);
+    } else if constexpr (std::is_null_pointer_v<T>) {
+        writer.putScalar(LOG_ARG_POINTER, 0);
+    } else if constexpr (std::is_pointer_v<T>) {
+        writer.putScalar(LOG_ARG_POINTER, reinterpret_cast<uintptr_t>(value));
+    } else {
+        static_assert(sizeof(T) == 0, "不支持的日志参数类型");
+    }
+}
+
+#if FG_LOG_BINARY
+// 二进制日志文件：格式串在首次出现时定义一次，之后的记录只保存 id 与参数
+class BinaryLogSink {
+public:
+    // 同一应用的多个进程共用包名目录：先抢占 log.bin，已被其他进程锁定时改用 log.<pid>.bin。
+    // 拿到锁之后才截断，不会清掉另一个进程正在写的文件
+    bool open(const std::string& path) {
+        close();
+        fd_ = openLocked(path);
+        if (fd_ < 0 && errno == EWOULDBLOCK) {
+            std::string fallback = path;
+            size_t dot = fallback.rfind('.');
+            size_t slash = fallback.rfind('/');
+            if (dot == std::string::npos || (slash != std::string::npos && dot < slash)) dot = fallback.size();
+            fallback.insert(dot, "." + std::to_string(getpid()));
+            __android_log_print(ANDROID_LOG_INFO, LOG_TAG, "二进制日志已被其他进程使用，改写 %s", fallback.c_str());
+            fd_ = openLocked(fallback);
+        }
+        if (fd_ < 0 || ftruncate(fd_, 0) != 0) {
+            close();
+            return false;
+        }
+        LogFileHeader header = {};
+        header.magic = kLogFileMagic;
+        header.version = kLogFileVersion;
+        header.realtime_ns = logTimestampNs(CLOCK_REALTIME);
+        header.monotonic_ns = logTimestampNs(CLOCK_MONOTONIC);
+        append(&header, sizeof(header));
+        format_ids_.clear();
+        return true;
+    }
+    
+    bool isOpen() const { return fd_ >= 0; }
+    
+    void writeRecord(const uint8_t* record, uint32_t tid) {
+        const LogRecordHeader* header = reinterpret_cast<const LogRecordHeader*>(record);
+        auto [it, inserted] = format_ids_.try_emplace(header->format, uint32_t(format_ids_.size()));
+        if (inserted) {
+            uint16_t length = uint16_t(std::min<size_t>(strlen(header->format), UINT16_MAX));
+            put(uint8_t(LOG_ENTRY_FORMAT));
+            put(it->second);
+            put(length);
+            append(header->format, length);
+        }
+        
+        uint16_t args_size = uint16_t(header->size - sizeof(LogRecordHeader));
+        put(uint8_t(LOG_ENTRY_RECORD));
+        put(it->second);
+        put(header->priority);
+        put(tid);
+        put(header->timestamp_ns);
+        put(args_size);
+        append(record + sizeof(LogRecordHeader), args_size);
+        
+        if (buffer_.size() >= 64 * 1024) {
+            flush();
+        }
+    }
+    
+    void writeDropped(uint32_t tid, uint64_t count) {
+        put(uint8_t(LOG_ENTRY_DROPPED));
+        put(tid);
+        put(count);
+    }
+    
+    void flush() {
+        size_t written = 0;
+        while (fd_ >= 0 && written < buffer_.size()) {
+            ssize_t n = ::write(fd_, buffer_.data() + written, buffer_.size() - written);
+            if (n < 0 && errno == EINTR) continue;
+            if (n <= 0) {
+                close();
+                break;
+            }
+            written += n;
+        }
+        buffer_.clear();
+    }
+    
+private:
+    template <typename T>
+    void put(const T& value) {
+        append(&value, sizeof(value));
+    }
+    
+    void append(const void* data, size_t size) {
+        const uint8_t* bytes = static_cast<const uint8_t*>(data);
+        buffer_.insert(buffer_.end(), bytes, bytes + size);
+    }
+    
+    // 打开并独占锁定（锁随 fd 关闭释放），失败返回 -1 并保留 errno
+    static int openLocked(const std::string& path) {
+        int fd = ::open(path.c_str(), O_WRONLY | O_CREAT | O_CLOEXEC, 0644);
+        if (fd >= 0 && flock(fd, LOCK_EX | LOCK_NB) != 0) {
+            int error = errno;
+            ::close(fd);
+            errno = error;
+            return -1;
+        }
+        return fd;
+    }
+    
+    void close() {
+        if (fd_ >= 0) {
+            ::close(fd_);
+            fd_ = -1;
+        }
+    }
+    
+    int fd_ = -1;
+    std::vector<uint8_t> buffer_;
+    std::unordered_map<const char*, uint32_t> format_ids_;
+};
+#endif
+
+// 日志后台：管理各线程的环形缓冲并在独立线程中排空
+class AsyncLogger {
+public:
+    static AsyncLogger& instance() {
+        // 不析构：进程退出时日志线程可能仍在运行
+        static AsyncLogger* logger = new AsyncLogger();
+        return *logger;
+    }
+    
+    void push(const uint8_t* record, size_t size) {
+        LogRing* ring = threadRing();
+        if (ring) {
+            ring->push(record, size);
+        } else {
+            // 线程退出阶段的日志
+            late_dropped_.fetch_add(1, std::memory_order_relaxed);
+        }
+    }
+    
+#if FG_LOG_BINARY
+    // 之后的日志写入二进制文件（由日志线程打开）
+    void openBinaryLog(std::string path) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        binary_log_path_ = std::move(path);
+    }
+#endif
+    
 private:
-    std::chrono::high_resolution_clock::time_point start_time;
+    // 线程退出时把环交还给日志线程
+    struct ThreadRingSlot {
+        LogRing* ring = nullptr;
+        ~ThreadRingSlot() {
+            if (ring) {
+                ring->orphaned.store(true, std::memory_order_release);
+                ring = nullptr;
+            }
+            exited = true;
+        }
+        bool exited = false;
+    };
+    
+    LogRing* threadRing() {
+        thread_local ThreadRingSlot slot;
+        if (!slot.ring && !slot.exited) {
+            slot.ring = acquireRing();
+        }
+        return slot.ring;
+    }
+    
+    LogRing* acquireRing() {
+        std::lock_guard<std::mutex> lock(mutex_);
+        LogRing* ring;
+        if (!free_rings_.empty()) {
+            ring = free_rings_.back();
+            free_rings_.pop_back();
+            ring->orphaned.store(false, std::memory_order_relaxed);
+        } else {
+            ring = new LogRing();
+        }
+        ring->tid = static_cast<uint32_t>(gettid());
+        rings_.push_back(ring);
+        
+        if (!drainer_started_) {
+            drainer_started_ = true;
+            std::thread(&AsyncLogger::drainLoop, this).detach();
+        }
+        return ring;
+    }
+    
+    void drainLoop() {
+        std::vector<LogRing*> rings;
+        char text[kLogMaxRecordSize];
+        int idle_ms = 1;
+        uint64_t late_dropped_reported = 0;
+        
+        for (;;) {
+            {
+                std::lock_guard<std::mutex> lock(mutex_);
+                rings = rings_;
+#if FG_LOG_BINARY
+                if (!binary_log_path_.empty()) {
+                    if (!binary_log_.open(binary_log_path_)) {
+                        __android_log_print(ANDROID_LOG_ERROR, LOG_TAG, "❌ 无法创建二进制日志: %s (%s)",
+                                            binary_log_path_.c_str(), strerror(errno));
+                    }
+                    binary_log_path_.clear();
+                }
+#endif
+            }
+            
+            size_t drained = 0;
+            for (LogRing* ring : rings) {
+                // 先读退出标记再排空，保证回收前没有遗漏的记录
+                bool orphaned = ring->orphaned.load(std::memory_order_acquire);
+                drained += ring->drain([&](const uint8_t* record, size_t) {
+                    const LogRecordHeader* header = reinterpret_cast<const LogRecordHeader*>(record);
+#if FG_LOG_BINARY
+                    if (binary_log_.isOpen()) {
+                        binary_log_.writeRecord(record, ring->tid);
+                        if (header->priority < ANDROID_LOG_ERROR) {
+                            return;
+                        }
+                    }
+#endif
+                    formatLogArgs(header->format, record + sizeof(LogRecordHeader), record + header->size,
+                                  text, sizeof(text));
+                    __android_log_write(header->priority, LOG_TAG, text);
+                });
+                
+                uint64_t dropped = ring->dropped.load(std::memory_order_relaxed);
+                if (dropped != ring->dropped_reported) {
+#if FG_LOG_BINARY
+                    if (binary_log_.isOpen()) {
+                        binary_log_.writeDropped(ring->tid, dropped - ring->dropped_reported);
+                    }
+#endif
+                    __android_log_print(ANDROID_LOG_WARN, LOG_TAG, "⚠️ 日志缓冲区已满，丢弃 %llu 条记录",
+                                        (unsigned long long)(dropped - ring->dropped_reported));
+                    ring->dropped_reported = dropped;
+                }
+                
+                if (orphaned) {
+                    recycleRing(ring);
+                }
+            }
+            
+            uint64_t late_dropped = late_dropped_.load(std::memory_order_relaxed);
+            if (late_dropped != late_dropped_reported) {
+                __android_log_print(ANDROID_LOG_WARN, LOG_TAG, "⚠️ 线程退出阶段丢弃 %llu 条日志",
+                                    (unsigned long long)(late_dropped - late_dropped_reported));
+                late_dropped_reported = late_dropped;
+            }
+            
+            // 有输出时立即继续，空闲时逐步退避到 20ms
+            if (drained > 0) {
+                idle_ms = 1;
+            } else {
+#if FG_LOG_BINARY
+                binary_log_.flush();
+#endif
+                std::this_thread::sleep_for(std::chrono::milliseconds(idle_ms));
+                idle_ms = std::min(idle_ms * 2, 20);
+            }
+        }
+    }
+    
+    void recycleRing(LogRing* ring) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        rings_.erase(std::remove(rings_.begin(), rings_.end(), ring), rings_.end());
+        ring->dropped.store(0, std::memory_order_relaxed);
+        ring->dropped_reported = 0;
+        free_rings_.push_back(ring);
+    }
+    
+    std::mutex mutex_;
+    std::vector<LogRing*> rings_;
+    std::vector<LogRing*> free_rings_;
+    bool drainer_started_ = false;
+    std::atomic<uint64_t> late_dropped_{0};
+#if FG_LOG_BINARY
+    std::string binary_log_path_;           // 待打开的文件，受 mutex_ 保护
+    BinaryLogSink binary_log_;              // 只在日志线程中使用
+#endif
+};
+
+// 生产者入口：编码到栈上后整条写入本线程的环
+template <typename... Args>
+inline void logAsync(int priority, const char* format, const Args&... args) {
+    alignas(8) uint8_t record[kLogMaxRecordSize];
+    LogRecordWriter writer(record, sizeof(record));
+    (encodeLogArg(writer, args), ...);
+    size_t size = writer.finish(priority, format);
+    AsyncLogger::instance().push(record, size);
+}
+
+// 只用于编译期检查格式串与参数是否匹配，从不调用
+__attribute__((format(printf, 1, 2))) static inline void checkLogFormat(const char*, ...) {}
+
+// "" fmt 要求格式串为字面量：记录中只保存其指针
+#define FG_LOG(priority, fmt, ...) do { \
+    if constexpr (kLogLevelEnabled<priority>) { \
+        if (false) checkLogFormat("" fmt __VA_OPT__(,) __VA_ARGS__); \
+        logAsync(priority, "" fmt __VA_OPT__(,) __VA_ARGS__); \
+    } \
+} while (0)
+
+#define LOGI(...) FG_LOG(ANDROID_LOG_INFO, __VA_ARGS__)
+#define LOGE(...) FG_LOG(ANDROID_LOG_ERROR, __VA_ARGS__)
+#define LOGD(...) FG_LOG(ANDROID_LOG_DEBUG, __VA_ARGS__)
+
+// ============================
+// ⏱️ Span 性能分析
+// ============================
+// ProfileSpan 在作用域内计时（CLOCK_MONOTONIC_RAW 纳秒），同一线程内的 span 自动形成父子关系。
+// 每个线程保留最近的事件用于导出 Chrome trace（chrome://tracing / Perfetto），
+// 并按名称汇总次数、总耗时、自身耗时（扣除子 span）与最小/最大值。
+
+static inline uint64_t profilerNowNs() {
+    timespec ts;
+    clock_gettime(CLOCK_MONOTONIC_RAW, &ts);
+    return uint64_t(ts.tv_sec) * 1000000000ull + uint64_t(ts.tv_nsec);
+}
+
+struct SpanEvent {
     const char* name;
+    uint64_t start_ns;
+    uint64_t duration_ns;
+    uint32_t depth;
+};
+
+struct SpanStats {
+    uint64_t count = 0;
+    uint64_t total_ns = 0;
+    uint64_t self_ns = 0;
+    uint64_t min_ns = UINT64_MAX;
+    uint64_t max_ns = 0;
+    
+    void add(uint64_t duration_ns, uint64_t child_ns) {
+        count++;
+        total_ns += duration_ns;
+        self_ns += duration_ns - std::min(child_ns, duration_ns);
+        min_ns = std::min(min_ns, duration_ns);
+        max_ns = std::max(max_ns, duration_ns);
+    }
+    
+    void merge(const SpanStats& other) {
+        count += other.count;
+        total_ns += other.total_ns;
+        self_ns += other.self_ns;
+        min_ns = std::min(min_ns, other.min_ns);
+        max_ns = std::max(max_ns, other.max_ns);
+    }
+};
+
+class SpanProfiler {
+public:
+    static SpanProfiler& instance() {
+        // 不析构：进程退出时其他线程可能仍在记录
+        static SpanProfiler* profiler = new SpanProfiler();
+        return *profiler;
+    }
+    
+    void record(const char* name, uint64_t start_ns, uint64_t duration_ns, uint64_t child_ns, uint32_t depth) {
+        ThreadBuffer* buffer = threadBuffer();
+        if (!buffer) return;
+        std::lock_guard<std::mutex> lock(buffer->mutex);
+        SpanEvent event = {name, start_ns, duration_ns, depth};
+        if (buffer->events.size() < kEventsPerThread) {
+            buffer->events.push_back(event);
+        } else {
+            // 满后覆盖最旧的事件
+            buffer->events[buffer->next] = event;
+            buffer->next = (buffer->next + 1) % kEventsPerThread;
+        }
+        buffer->stats[name].add(duration_ns, child_ns);
+    }
+    
+    // 写出 Chrome trace-event JSON。锁内只复制事件（名称为静态字符串，复制指针即可），
+    // 写文件时不持有任何锁，Hook 线程的 record() 与首次注册不会被磁盘 I/O 阻塞
+    bool writeTrace(const char* path) {
+        struct ThreadEvents {
+            uint32_t tid;
+            char thread_name[16];
+            std::vector<SpanEvent> events;
+        };
+        std::vector<ThreadEvents> threads;
+        {
+            std::lock_guard<std::mutex> registry_lock(mutex_);
+            threads.reserve(buffers_.size());
+            for (ThreadBuffer* buffer : buffers_) {
+                threads.push_back({buffer->tid, {}, {}});
+                ThreadEvents& copy = threads.back();
+                memcpy(copy.thread_name, buffer->thread_name, sizeof(copy.thread_name));
+                std::lock_guard<std::mutex> lock(buffer->mutex);
+                copy.events = buffer->events;
+            }
+        }
+        
+        FILE* file = fopen(path, "w");
+        if (!file) {
+            LOGE("❌ 无法创建 trace 文件: %s (%s)", path, strerror(errno));
+            return false;
+        }
+        
+        int pid = getpid();
+        size_t event_count = 0;
+        bool first = true;
+        auto separator = [&]() {
+            fputs(first ? "\n" : ",\n", file);
+            first = false;
+        };
+        
+        fputs("{\"displayTimeUnit\":\"ns\",\"traceEvents\":[", file);
+        for (const ThreadEvents& thread : threads) {
+            separator();
+            fprintf(file, "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":%d,\"tid\":%u,\"args\":{\"name\":", pid, thread.tid);
+            writeJsonString(file, thread.thread_name);
+            fputs("}}", file);
+            
+            for (const SpanEvent& event : thread.events) {
+                separator();
+                fputs("{\"name\":", file);
+                writeJsonString(file, event.name);
+                fprintf(file, ",\"ph\":\"X\",\"ts\":%.3f,\"dur\":%.3f,\"pid\":%d,\"tid\":%u,\"args\":{\"depth\":%u}}",
+                        event.start_ns / 1000.0, event.duration_ns / 1000.0, pid, thread.tid, event.depth);
+                event_count++;
+            }
+        }
+        fputs("\n]}\n", file);
+        
+        bool ok = fclose(file) == 0;
+        LOGI("⏱️ trace 已写入 %s (%zu 个事件, %zu 个线程)", path, event_count, threads.size());
+        return ok;
+    }
+    
+    // 按总耗时降序输出各 span 的汇总
+    void logSummary() {
+        std::unordered_map<std::string_view, SpanStats> merged;
+        {
+            std::lock_guard<std::mutex> registry_lock(mutex_);
+            for (const auto& [name, stats] : retired_stats_) {
+                merged[name].merge(stats);
+            }
+            for (ThreadBuffer* buffer : buffers_) {
+                std::lock_guard<std::mutex> lock(buffer->mutex);
+                for (const auto& [name, stats] : buffer->stats) {
+                    merged[name].merge(stats);
+                }
+            }
+        }
+        
+        std::vector<std::pair<std::string_view, SpanStats>> sorted(merged.begin(), merged.end());
+        std::sort(sorted.begin(), sorted.end(),
+            [](const auto& a, const auto& b) { return a.second.total_ns > b.second.total_ns; });
+        
+        LOGI("⏱️ Span 汇总 (%zu 项):", sorted.size());
+        for (const auto& [name, stats] : sorted) {
+            LOGI("⏱️ [%.*s] 次数=%llu 总计=%.3f ms 自身=%.3f ms 平均=%.1f us 最小=%.1f us 最大=%.1f us",
+                 (int)name.size(), name.data(), (unsigned long long)stats.count,
+                 stats.total_ns / 1e6, stats.self_ns / 1e6, stats.total_ns / 1e3 / stats.count,
+                 stats.min_ns / 1e3, stats.max_ns / 1e3);
+        }
+    }
+    
+private:
+    static constexpr size_t kEventsPerThread = 4096;
+    static constexpr size_t kMaxRetiredBuffers = 32;
+    
+    struct ThreadBuffer {
+        std::mutex mutex;
+        uint32_t tid = 0;
+        char thread_name[16] = {};
+        bool retired = false;
+        std::vector<SpanEvent> events;
+        size_t next = 0;
+        std::unordered_map<const char*, SpanStats> stats;
+    };
+    
+    // 线程退出时保留其事件，超过上限后释放最早退出线程的缓冲（汇总数据保留）
+    struct ThreadBufferSlot {
+        ThreadBuffer* buffer = nullptr;
+        bool exited = false;
+        ~ThreadBufferSlot() {
+            if (buffer) {
+                SpanProfiler::instance().retire(buffer);
+                buffer = nullptr;
+            }
+            exited = true;
+        }
+    };
+    
+    ThreadBuffer* threadBuffer() {
+        thread_local ThreadBufferSlot slot;
+        if (!slot.buffer && !slot.exited) {
+            ThreadBuffer* buffer = new ThreadBuffer();
+            buffer->tid = static_cast<uint32_t>(gettid());
+            pthread_getname_np(pthread_self(), buffer->thread_name, sizeof(buffer->thread_name));
+            std::lock_guard<std::mutex> lock(mutex_);
+            buffers_.push_back(buffer);
+            slot.buffer = buffer;
+        }
+        return slot.buffer;
+    }
+    
+    void retire(ThreadBuffer* buffer) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        buffer->retired = true;
+        retired_order_.push_back(buffer);
+        if (retired_order_.size() <= kMaxRetiredBuffers) {
+            return;
+        }
+        ThreadBuffer* oldest = retired_order_.front();
+        retired_order_.pop_front();
+        for (const auto& [name, stats] : oldest->stats) {
+            retired_stats_[name].merge(stats);
+        }
+        buffers_.erase(std::remove(buffers_.begin(), buffers_.end(), oldest), buffers_.end());
+        delete oldest;
+    }
+    
+    static void writeJsonString(FILE* file, const char* text) {
+        fputc('"', file);
+        for (const unsigned char* p = reinterpret_cast<const unsigned char*>(text); *p; p++) {
+            if (*p == '"' || *p == '\\') {
+                fputc('\\', file);
+                fputc(*p, file);
+            } else if (*p < 0x20) {
+                fprintf(file, "\\u%04x", *p);
+            } else {
+                fputc(*p, file);
+            }
+        }
+        fputc('"', file);
+    }
+    
+    std::mutex mutex_;
+    std::vector<ThreadBuffer*> buffers_;
+    std::deque<ThreadBuffer*> retired_order_;
+    std::unordered_map<std::string_view, SpanStats> retired_stats_;
+};
+
+// 作用域 span：构造时开始、析构时结束；next() 结束当前阶段并以新名称开始下一阶段
+class ProfileSpan {
+public:
+    explicit ProfileSpan(const char* name) : name_(name), parent_(t_current), start_ns_(profilerNowNs()) {
+        depth_ = parent_ ? parent_->depth_ + 1 : 0;
+        t_current = this;
+    }
+    
+    ~ProfileSpan() {
+        finish(profilerNowNs());
+        t_current = parent_;
+    }
+    
+    ProfileSpan(const ProfileSpan&) = delete;
+    ProfileSpan& operator=(const ProfileSpan&) = delete;
+    
+    uint64_t startNs() const { return start_ns_; }
+    
+    void next(const char* name) {
+        uint64_t now = profilerNowNs();
+        finish(now);
+        name_ = name;
+        start_ns_ = now;
+        child_ns_ = 0;
+    }
+    
+private:
+    void finish(uint64_t end_ns) {
+        uint64_t duration = end_ns - start_ns_;
+        if (parent_) {
+            parent_->child_ns_ += duration;
+        }
+        SpanProfiler::instance().record(name_, start_ns_, duration, child_ns_, depth_);
+    }
+    
+    static inline thread_local ProfileSpan* t_current = nullptr;
+    
+    const char* name_;
+    ProfileSpan* parent_;
+    uint64_t start_ns_;
+    uint64_t child_ns_ = 0;
+    uint32_t depth_;
+};
+
+// ============================
+// 📊 Hook 调用耗时直方图
+// ============================
+// HookProbe 放在替换函数入口，统计调用次数与自身耗时（总耗时减去 callOriginal 中原函数的耗时），
+// 写入按 CPU 分片的对数分桶直方图：不同线程上的热点 Hook 各写各的缓存行，快照时再合并。
+
+enum class HookMetricId : uint8_t {
+    CHECK_MENU,
+    INIT_FX,
+    UPDATE_MONEY,
+    UPDATE_GOLD,
+    SEND_DATA,
+    ON_HTTP_COMPLETED,
+    PARSE_JSON,
+    JSON_CREATE,
+    JSON_DISPOSE,
+    SCHEDULER_UPDATE,
+    EVAL_STRING,
+    SET_TIME_SCALE,
+    LUA_LOADBUFFER,
+    COUNT
+};
+
+// 同时作为 span 名称
+static const char* const kHookMetricNames[] = {
+    "hook:UI_FX::checkMenu",
+    "hook:UI_FX::initFX",
+    "hook:Game_Unpack::updateMoney",
+    "hook:Game_Unpack::updateGold",
+    "hook:CurlHttp::sendData",
+    "hook:CurlHttp::onHttpRequestCompleted",
+    "hook:CurlHttp::parseJson",
+    "hook:Json_create",
+    "hook:Json_dispose",
+    "hook:Scheduler::update",
+    "hook:ScriptEngine::evalString",
+    "hook:UnityEngine.Time::set_timeScale",
+    "hook:luaL_loadbufferx",
+};
+static_assert(std::size(kHookMetricNames) == size_t(HookMetricId::COUNT), "kHookMetricNames 与 HookMetricId 不一致");
+
+// 对数分桶：每个 2 的幂区间再分 4 个子桶（相对误差 ≤ 25%），覆盖 0 ns ~ 约 30 分钟
+static constexpr size_t kHistogramSubBits = 2;
+static constexpr size_t kHistogramBuckets = (40 << kHistogramSubBits);
+
+static inline size_t histogramBucket(uint64_t value) {
+    if (value < (1u << kHistogramSubBits)) {
+        return value;
+    }
+    unsigned msb = 63 - __builtin_clzll(value);
+    size_t sub = (value >> (msb - kHistogramSubBits)) & ((1u << kHistogramSubBits) - 1);
+    return std::min(((msb - kHistogramSubBits + 1) << kHistogramSubBits) + sub, kHistogramBuckets - 1);
+}
+
+// 桶的上界（含）
+static inline uint64_t histogramBucketUpper(size_t bucket) {
+    if (bucket < (1u << kHistogramSubBits)) {
+        return bucket;
+    }
+    unsigned msb = unsigned(bucket >> kHistogramSubBits) + kHistogramSubBits - 1;
+    uint64_t sub = bucket & ((1u << kHistogramSubBits) - 1);
+    uint64_t lower = (uint64_t(1) << msb) + (sub << (msb - kHistogramSubBits));
+    return lower + (uint64_t(1) << (msb - kHistogramSubBits)) - 1;
+}
+
+struct HookHistogramSnapshot {
+    uint64_t count = 0;
+    uint64_t sum_ns = 0;
+    uint64_t max_ns = 0;
+    std::array<uint64_t, kHistogramBuckets> buckets = {};
+    
+    // 百分位（返回所在桶的上界）
+    uint64_t percentile(double p) const {
+        if (count == 0) return 0;
+        uint64_t rank = std::max<uint64_t>(1, uint64_t(p * count + 0.5));
+        uint64_t seen = 0;
+        for (size_t i = 0; i < buckets.size(); i++) {
+            seen += buckets[i];
+            if (seen >= rank) {
+                return std::min(histogramBucketUpper(i), max_ns);
+            }
+        }
+        return max_ns;
+    }
+};
+
+class HookMetrics {
+public:
+    static HookMetrics& instance() {
+        // 不析构：进程退出时 Hook 可能仍在执行
+        static HookMetrics* metrics = new HookMetrics();
+        return *metrics;
+    }
+    
+    void record(HookMetricId id, uint64_t self_ns) {
+        Shard& shard = shards_[currentShard() * size_t(HookMetricId::COUNT) + size_t(id)];
+        shard.count.fetch_add(1, std::memory_order_relaxed);
+        shard.sum_ns.fetch_add(self_ns, std::memory_order_relaxed);
+        shard.buckets[histogramBucket(self_ns)].fetch_add(1, std::memory_order_relaxed);
+        uint64_t max = shard.max_ns.load(std::memory_order_relaxed);
+        while (self_ns > max && !shard.max_ns.compare_exchange_weak(max, self_ns, std::memory_order_relaxed)) {}
+    }
+    
+    // 合并所有分片；与 record 并发时各字段之间可能相差几次调用
+    HookHistogramSnapshot snapshot(HookMetricId id) const {
+        HookHistogramSnapshot result;
+        for (size_t cpu = 0; cpu < shard_count_; cpu++) {
+            const Shard& shard = shards_[cpu * size_t(HookMetricId::COUNT) + size_t(id)];
+            result.count += shard.count.load(std::memory_order_relaxed);
+            result.sum_ns += shard.sum_ns.load(std::memory_order_relaxed);
+            result.max_ns = std::max(result.max_ns, shard.max_ns.load(std::memory_order_relaxed));
+            for (size_t i = 0; i < kHistogramBuckets; i++) {
+                result.buckets[i] += shard.buckets[i].load(std::memory_order_relaxed);
+            }
+        }
+        return result;
+    }
+    
+    // 输出有调用记录的 Hook
+    void logSummary() const {
+        LOGI("📊 Hook 自身耗时统计 (%zu 个 CPU 分片):", shard_count_);
+        for (size_t i = 0; i < size_t(HookMetricId::COUNT); i++) {
+            HookHistogramSnapshot s = snapshot(HookMetricId(i));
+            if (s.count == 0) continue;
+            LOGI("📊 [%s] 次数=%llu 平均=%.2f us p50=%.2f us p90=%.2f us p99=%.2f us p999=%.2f us 最大=%.2f us",
+                 kHookMetricNames[i], (unsigned long long)s.count, s.sum_ns / 1e3 / s.count,
+                 s.percentile(0.50) / 1e3, s.percentile(0.90) / 1e3, s.percentile(0.99) / 1e3,
+                 s.percentile(0.999) / 1e3, s.max_ns / 1e3);
+        }
+    }
+    
+private:
+    struct alignas(64) Shard {
+        std::atomic<uint64_t> count{0};
+        std::atomic<uint64_t> sum_ns{0};
+        std::atomic<uint64_t> max_ns{0};
+        std::atomic<uint64_t> buckets[kHistogramBuckets] = {};
+    };
+    
+    HookMetrics() {
+        long cpus = sysconf(_SC_NPROCESSORS_CONF);
+        shard_count_ = cpus > 0 ? size_t(cpus) : 1;
+        shards_.reset(new Shard[shard_count_ * size_t(HookMetricId::COUNT)]);
+    }
+    
+    // sched_getcpu 在 arm64 上是系统调用：每个线程缓存结果，每 64 次刷新一次。
+    // 分片只影响争用，线程迁移后写到旧分片仍然正确
+    size_t currentShard() const {
+        thread_local int cpu = -1;
+        thread_local uint32_t uses = 0;
+        if (cpu < 0 || (++uses & 63) == 0) {
+            cpu = sched_getcpu();
+            if (cpu < 0) cpu = 0;
+        }
+        return size_t(cpu) % shard_count_;
+    }
+    
+    size_t shard_count_;
+    std::unique_ptr<Shard[]> shards_;
+};
+
+// Hook 上的同名 span 默认关闭：直方图计数始终开启，span 每次调用还要加锁查找线程缓冲区并写环，
+// 逐帧 Hook（Scheduler::update 等）上开销不可忽略。需要 trace 时用 fg_profiler_trace_hooks 打开
+static std::atomic<bool> g_hook_spans_enabled{false};
+
+// Hook 入口探针：开启时同时打开同名 span
+class HookProbe {
+public:
+    explicit HookProbe(HookMetricId id) : id_(id), start_ns_(profilerNowNs()) {
+        if (g_hook_spans_enabled.load(std::memory_order_relaxed)) {
+            span_.emplace(kHookMetricNames[size_t(id)]);
+        }
+    }
+    
+    ~HookProbe() {
+        uint64_t total_ns = profilerNowNs() - start_ns_;
+        HookMetrics::instance().record(id_, total_ns - std::min(original_ns_, total_ns));
+    }
     
+    HookProbe(const HookProbe&) = delete;
+    HookProbe& operator=(const HookProbe&) = delete;
+    
+    // 调用原函数，耗时不计入自身耗时
+    template <typename Fn, typename... Args>
+    decltype(auto) callOriginal(Fn fn, Args&&... args) {
+        OriginalTimer timer(original_ns_);
+        return fn(std::forward<Args>(args)...);
+    }
+    
+private:
+    struct OriginalTimer {
+        explicit OriginalTimer(uint64_t& total) : total_(total), start_ns_(profilerNowNs()) {}
+        ~OriginalTimer() { total_ += profilerNowNs() - start_ns_; }
+        uint64_t& total_;
+        uint64_t start_ns_;
+    };
+    
+    HookMetricId id_;
+    uint64_t start_ns_;
+    uint64_t original_ns_ = 0;
+    std::optional<ProfileSpan> span_;
+};
+
+
+// 游戏引擎类型
+enum class GameEngine {
+    UNKNOWN,
+    UNITY,
+    UNREAL,
+    COCOS2D_CPP,   // Cocos2d-x (C++ 版本)
+    COCOS2D_JS,    // Cocos2d-js (JavaScript 版本)
+    GODOT
+};
+
+// 从路径中提取库名称
+std::string extractLibraryName(const std::string& path) {
+    size_t last_slash = path.rfind('/');
+    if (last_slash == std::string::npos) return path;
+    return path.substr(last_slash + 1);
+}
+
+// 从路径视图中提取库名称（不分配）
+static std::string_view extractLibraryNameView(std::string_view path) {
+    size_t last_slash = path.rfind('/');
+    if (last_slash == std::string_view::npos) return path;
+    return path.substr(last_slash + 1);
+}
+
+// ============================
+// 模块映射索引
+// ============================
+// 一个 ELF 的所有映射段合并为一个模块（保留各段与整体范围），同名模块不会互相覆盖。
+// 模块从文件偏移 0 或以 ELF 头开始的段起算：直接从 APK 加载的库（extractNativeLibs=false）
+// 路径都是 base.apk，按此规则各自成为独立模块，名称取自内存中的 DT_SONAME。
+// 支持按库名、完整路径与地址查找；地址查找在按起始地址排序的段区间数组上做无分支二分，
+// 不回调 gum，可在 Hook 中用于定位返回地址所属模块。
+
+struct ModuleSegment {
+    uintptr_t start;
+    uintptr_t end;
+    uint64_t offset;        // 文件偏移
+    uint8_t perms;          // MapPerm 位掩码
+};
+
+struct ModuleInfo {
+    std::string path;
+    std::string_view name;  // path 的最后一段；APK 内的库为 soname（或 "base.apk!0x偏移"）
+    std::string embedded_name;  // APK 内的库：name 指向这里
+    uint64_t file_offset;   // 第一段的文件偏移（APK 内的库即其在 APK 中的偏移）
+    uint64_t inode;
+    uintptr_t base;         // 最低段起始地址
+    uintptr_t end;          // 最高段结束地址
+    std::vector<ModuleSegment> segments;
+};
+
+class ModuleIndex {
+public:
+    ModuleIndex() = default;
+    ModuleIndex(const ModuleIndex&) = delete;
+    ModuleIndex& operator=(const ModuleIndex&) = delete;
+    
+    // 从快照构建：只收录有文件路径的映射（"[anon:...]"、"[stack]" 等伪路径除外）
+    static std::shared_ptr<const ModuleIndex> build(const MapsSnapshot& snapshot) {
+        auto index = std::make_shared<ModuleIndex>();
+        index->content_hash_ = snapshot.contentHash();
+        // 每个路径最近一个模块，用于把不相邻的同文件段归并回去
+        std::unordered_map<std::string_view, uint32_t> last_by_path;
+        uint32_t previous = UINT32_MAX;     // 上一条文件映射所属模块
+        FileReader files;
+        std::vector<bool> embedded_elf;     // 与 modules_ 对应：APK 内直接映射的库
+        
+        for (const MapRecord& rec : snapshot.records()) {
+            if (rec.path.empty() || rec.path[0] != '/') continue;
+            
+            // 库的各段紧邻出现，非首段延续上一模块；APK 的其它数据映射（资源、dex 等）自成一个模块
+            uint32_t owner = UINT32_MAX;
+            // 只在 APK 映射上探测 ELF 头：其它文件的非零偏移段不会是库的起始
+            bool elf_in_apk = isApkPath(rec.path) && startsWithElfHeader(files, rec);
+            bool starts_module = rec.offset == 0 || elf_in_apk;
+            if (!starts_module) {
+                if (previous != UINT32_MAX && index->modules_[previous].path == rec.path) {
+                    owner = previous;
+                } else if (!isApkPath(rec.path)) {
+                    auto it = last_by_path.find(rec.path);
+                    if (it != last_by_path.end()) owner = it->second;
+                }
+            }
+            if (owner == UINT32_MAX) {
+                owner = uint32_t(index->modules_.size());
+                index->modules_.push_back({std::string(rec.path), {}, {}, rec.offset, rec.inode, rec.start, rec.end, {}});
+                embedded_elf.push_back(elf_in_apk);
+                last_by_path[rec.path] = owner;
+            }
+            ModuleInfo& module = index->modules_[owner];
+            module.base = std::min(module.base, rec.start);
+            module.end = std::max(module.end, rec.end);
+            module.segments.push_back({rec.start, rec.end, rec.offset, rec.perms});
+            previous = owner;
+            
+            // 快照记录已按地址排序且互不重叠
+            index->starts_.push_back(rec.start);
+            index->intervals_.push_back({rec.end, owner});
+        }
+        
+        // 模块数组定型后再建立指向 path / embedded_name 的视图
+        for (uint32_t i = 0; i < index->modules_.size(); ++i) {
+            ModuleInfo& module = index->modules_[i];
+            module.name = extractLibraryNameView(module.path);
+            if (embedded_elf[i]) {
+                module.embedded_name = readSoname(files, module);
+                if (module.embedded_name.empty()) {
+                    char fallback[64];
+                    snprintf(fallback, sizeof(fallback), "!0x%llx", (unsigned long long)module.file_offset);
+                    module.embedded_name.assign(module.name).append(fallback);
+                }
+                module.name = module.embedded_name;
+            }
+            index->by_path_.emplace(module.path, i);
+            index->by_name_.emplace(module.name, i);
+        }
+        return index;
+    }
+    
+    const std::vector<ModuleInfo>& modules() const { return modules_; }
+    
+    // 构建时 maps 内容的哈希
+    uint64_t contentHash() const { return content_hash_; }
+    
+    // 同一路径有多个模块（如 APK 内的多个库）时返回基址最低的一个
+    const ModuleInfo* findByPath(std::string_view path) const {
+        return lowestBase(by_path_.equal_range(path));
+    }
+    
+    // 同名模块有多个时返回基址最低的一个；需要全部时用 findAllByName
+    const ModuleInfo* findByName(std::string_view name) const {
+        return lowestBase(by_name_.equal_range(name));
+    }
+    
+    std::vector<const ModuleInfo*> findAllByName(std::string_view name) const {
+        std::vector<const ModuleInfo*> result;
+        auto [first, last] = by_name_.equal_range(name);
+        for (auto it = first; it != last; ++it) {
+            result.push_back(&modules_[it->second]);
+        }
+        return result;
+    }
+    
+    // O(log n)：找最后一个 start <= address 的段，再检查是否落在段内
+    const ModuleInfo* findByAddress(uintptr_t address) const {
+        size_t n = starts_.size();
+        if (n == 0 || address < starts_[0]) return nullptr;
+        const uintptr_t* base = starts_.data();
+        while (n > 1) {
+            size_t half = n / 2;
+            base = (base[half] <= address) ? base + half : base;
+            n -= half;
+        }
+        const Interval& interval = intervals_[base - starts_.data()];
+        return address < interval.end ? &modules_[interval.module] : nullptr;
+    }
+    
+    // 全局共享的最新索引（refreshModuleIndex 发布），尚未构建时为空
+    static std::shared_ptr<const ModuleIndex> current() {
+        std::lock_guard<std::mutex> lock(current_mutex_);
+        return current_;
+    }
+    
+    static void publish(std::shared_ptr<const ModuleIndex> index) {
+        std::lock_guard<std::mutex> lock(current_mutex_);
+        current_ = std::move(index);
+    }
+    
+private:
+    struct Interval {
+        uintptr_t end;
+        uint32_t module;
+    };
+    
+    using NameMap = std::unordered_multimap<std::string_view, uint32_t>;
+    
+    const ModuleInfo* lowestBase(std::pair<NameMap::const_iterator, NameMap::const_iterator> range) const {
+        const ModuleInfo* best = nullptr;
+        for (auto it = range.first; it != range.second; ++it) {
+            const ModuleInfo& module = modules_[it->second];
+            if (!best || module.base < best->base) best = &module;
+        }
+        return best;
+    }
+    
+    static bool isApkPath(std::string_view path) {
+        return path.size() > 4 && path.compare(path.size() - 4, 4, ".apk") == 0;
+    }
+    
+    // ELF 探测读文件而不是映射内存：其它包或框架的 APK 被替换、截断后，读映射会触发 SIGBUS。
+    // 一次 build 内按路径复用 fd，打不开（无权限等）的路径记为 -1，视为不含库
+    class FileReader {
+    public:
+        FileReader() = default;
+        FileReader(const FileReader&) = delete;
+        FileReader& operator=(const FileReader&) = delete;
+        
+        ~FileReader() {
+            for (const auto& [path, fd] : fds_) {
+                if (fd >= 0) close(fd);
+            }
+        }
+        
+        // 读满 size 字节才返回 true
+        bool read(std::string_view path, uint64_t offset, void* out, size_t size) {
+            auto it = fds_.find(path);
+            if (it == fds_.end()) {
+                it = fds_.emplace(path, open(std::string(path).c_str(), O_RDONLY | O_CLOEXEC)).first;
+            }
+            return it->second >= 0 && pread(it->second, out, size, off_t(offset)) == ssize_t(size);
+        }
+        
+    private:
+        std::unordered_map<std::string_view, int> fds_;     // 键指向快照中的路径
+    };
+    
+    static bool startsWithElfHeader(FileReader& files, const MapRecord& rec) {
+        char magic[SELFMAG];
+        return (rec.perms & MAP_PERM_READ) && rec.end - rec.start >= sizeof(Elf64_Ehdr) &&
+               files.read(rec.path, rec.offset, magic, sizeof(magic)) && memcmp(magic, ELFMAG, SELFMAG) == 0;
+    }
+    
+    // 从 APK 中库的文件内容读取 DT_SONAME（偏移均相对库在 APK 中的起点）；任何一步读不全都放弃
+    static std::string readSoname(FileReader& files, const ModuleInfo& module) {
+        static constexpr size_t kMaxProgramHeaders = 64;
+        static constexpr size_t kMaxDynamicEntries = 512;
+        
+        uint64_t base = module.file_offset;
+        Elf64_Ehdr ehdr;
+        if (!files.read(module.path, base, &ehdr, sizeof(ehdr)) || ehdr.e_ident[EI_CLASS] != ELFCLASS64 ||
+            ehdr.e_phentsize != sizeof(Elf64_Phdr) || ehdr.e_phnum == 0 || ehdr.e_phnum > kMaxProgramHeaders) {
+            return "";
+        }
+        
+        Elf64_Phdr phdrs[kMaxProgramHeaders];
+        if (!files.read(module.path, base + ehdr.e_phoff, phdrs, ehdr.e_phnum * sizeof(Elf64_Phdr))) return "";
+        const Elf64_Phdr* dynamic = nullptr;
+        for (size_t i = 0; i < ehdr.e_phnum; ++i) {
+            if (phdrs[i].p_type == PT_DYNAMIC) dynamic = &phdrs[i];
+        }
+        if (!dynamic) return "";
+        
+        Elf64_Dyn dyn[kMaxDynamicEntries];
+        size_t dyn_count = std::min<size_t>(dynamic->p_filesz / sizeof(Elf64_Dyn), kMaxDynamicEntries);
+        if (dyn_count == 0 || !files.read(module.path, base + dynamic->p_offset, dyn, dyn_count * sizeof(Elf64_Dyn))) {
+            return "";
+        }
+        uint64_t strtab = 0, soname = UINT64_MAX;
+        for (size_t i = 0; i < dyn_count && dyn[i].d_tag != DT_NULL; ++i) {
+            if (dyn[i].d_tag == DT_STRTAB) strtab = dyn[i].d_un.d_ptr;
+            if (dyn[i].d_tag == DT_SONAME) soname = dyn[i].d_un.d_val;
+        }
+        if (strtab == 0 || soname == UINT64_MAX) return "";
+        
+        // DT_STRTAB 是虚拟地址，经所在的 PT_LOAD 换算为文件偏移
+        uint64_t strtab_offset = UINT64_MAX;
+        for (size_t i = 0; i < ehdr.e_phnum; ++i) {
+            const Elf64_Phdr& load = phdrs[i];
+            if (load.p_type == PT_LOAD && strtab >= load.p_vaddr && strtab - load.p_vaddr < load.p_filesz) {
+                strtab_offset = load.p_offset + (strtab - load.p_vaddr);
+                break;
+            }
+        }
+        if (strtab_offset == UINT64_MAX) return "";
+        
+        // 名称可能靠近文件尾，逐块缩短直到读得到
+        char name[256];
+        for (size_t size = sizeof(name); size >= 16; size /= 2) {
+            if (files.read(module.path, base + strtab_offset + soname, name, size)) {
+                size_t length = strnlen(name, size);
+                return length < size ? std::string(name, length) : "";
+            }
+        }
+        return "";
+    }
+    
+    uint64_t content_hash_ = 0;
+    std::vector<ModuleInfo> modules_;
+    std::vector<uintptr_t> starts_;         // 与 intervals_ 一一对应，二分只访问这个数组
+    std::vector<Interval> intervals_;
+    NameMap by_path_;
+    NameMap by_name_;
+    
+    static inline std::mutex current_mutex_;
+    static inline std::shared_ptr<const ModuleIndex> current_;
+};
+
+// 重新读取 /proc/self/maps，构建并发布模块索引
+static std::shared_ptr<const ModuleIndex> refreshModuleIndex() {
+    ProfileSpan span("refreshModuleIndex");
+    
+    // 模块加载回调可能来自任意线程：共用一份快照缓冲区，串行刷新
+    static std::mutex refresh_mutex;
+    static MapsSnapshot snapshot;
+    std::lock_guard<std::mutex> lock(refresh_mutex);
+    if (!snapshot.read()) {
+        LOGE("无法打开 /proc/self/maps");
+        return ModuleIndex::current();
+    }
+    
+    // maps 未变化时沿用当前索引
+    std::shared_ptr<const ModuleIndex> index = ModuleIndex::current();
+    if (index && index->contentHash() == snapshot.contentHash()) {
+        return index;
+    }
+    index = ModuleIndex::build(snapshot);
+    ModuleIndex::publish(index);
+    LOGI("解析 maps，共 %zu 条映射，%zu 个模块", snapshot.records().size(), index->modules().size());
+    return index;
+}
+
+// 把地址描述为 "libfoo.so+0x1234"（相对模块基址），不在已知模块内时为 "0x..."
+static std::string describeAddress(uintptr_t address) {
+    char text[256];
+    std::shared_ptr<const ModuleIndex> index = ModuleIndex::current();
+    const ModuleInfo* module = index ? index->findByAddress(address) : nullptr;
+    if (module) {
+        snprintf(text, sizeof(text), "%.*s+0x%lx", int(module->name.size()), module->name.data(),
+                 (unsigned long)(address - module->base));
+    } else {
+        snprintf(text, sizeof(text), "0x%lx", (unsigned long)address);
+    }
+    return text;
+}
+
+// 从路径中提取包名
+std::string extractPackageName(const std::string& path) {
+    // 格式1：/data/data/com.game.pkg/files/libcpp_shared.so
+    //        提取：com.game.pkg
+    // 格式2：/data/app/~~xxx/com.sqw.jwdzg.jwdzg_ptzy-xxx==/lib/arm64/libcpp_shared.so
+    //        提取：com.sqw.jwdzg.jwdzg_ptzy
+ 
+    // 尝试格式1：/data/data/包名/files/...
+    // ✅ 优化：通过 /files/ 定位，向前提取包名
+    size_t files_pos = path.find("/files/");
+    if (files_pos != std::string::npos) {
+        // files_pos 本身就是 /files/ 前面的 '/'
+        size_t pkg_end = files_pos;
+        
+        // 向前找到包名起始位置的 '/'（/data/data/ 后面）
+        size_t pkg_start = path.rfind('/', pkg_end - 1);
+        if (pkg_start != std::string::npos) {
+            std::string package_name = path.substr(pkg_start + 1, pkg_end - pkg_start - 1);
+            
+            // 验证是否为有效包名（至少包含一个点）
+            if (package_name.find('.') != std::string::npos) {
+                return package_name;
+            }
+        }
+    }
+    
+    // 尝试格式2和格式3：/data/app/ 路径
+    // 格式2：/data/app/~~xxx/包名-xxx==/
+    // 格式3：/data/app/包名-xxx==/（直接包名，无 ~~xxx/ 前缀）
+    // /data/app/bin.mt.plus-1/base.apk
+    size_t data_pos = path.find("/data/app/");
+    if (data_pos != std::string::npos) {
+        // ✅ 一步式实现：先切割再提取 (getgamepkg 方式)
+        // 1. 找到最后一个 '-' 并截取之前的部分
+        std::string beforeDash = path.substr(0, path.find_last_of('-'));
+        
+        // 2. 找到最后一个 '/' 并提取包名部分
+        size_t lastSlash = beforeDash.find_last_of('/');
+        if (lastSlash != std::string::npos) {
+            std::string tpkg = beforeDash.substr(lastSlash + 1);
+            
+            // 3. 再次去除第一个 '-' 后的内容（去除包名中的版本后缀）
+            std::string package_name = tpkg.substr(0, tpkg.find("-"));
+            
+            // 验证是否为有效包名（至少包含一个点）
+            if (package_name.find('.') != std::string::npos) {
+                return package_name;
+            }
+        }
+    }
+    
+    return "";
+}
+
+// ============================
+// 进程身份（包名与 APK 路径）
+// ============================
+// 包名只解析一次：优先取 /proc/self/cmdline（应用进程的 argv[0] 即包名，子进程带 ":进程名" 后缀），
+// 且要求 maps 中有该包名的 base.apk；否则从 libcpp_shared.so 的加载路径提取。base.apk 在 maps 快照上按字面子串匹配查找
+// （isBaseApkOf/findBaseApk，见 maps_snapshot.h）。
+class ProcessIdentity {
+public:
+    // 解析失败时为空
+    static const std::string& packageName() {
+        static const std::string package_name = resolvePackageName();
+        return package_name;
+    }
+    
+    // 解压后的库目录：/data/app/.../pkg-xxx/base.apk → /data/app/.../pkg-xxx/lib/arm64/
+    static std::string libraryDir(std::string_view base_apk) {
+        size_t last_slash = base_apk.rfind('/');
+        std::string dir(base_apk.substr(0, last_slash + 1));
+        return dir.append("lib/arm64/");
+    }
+    
+private:
+    static std::string resolvePackageName() {
+        ProfileSpan span("ProcessIdentity::resolvePackageName");
+        // 进程名可以是自定义的 android:process（如包 com.foo 的 com.foo.game.svc），
+        // 只有存在对应的 "/<进程名>-…/base.apk" 映射时才当作包名
+        std::string package_name = readCmdline();
+        if (!package_name.empty()) {
+            MapsSnapshot snapshot;
+            if (snapshot.read() && !findBaseApk(snapshot, package_name).empty()) {
+                LOGI("从 cmdline 读取包名: %s", package_name.c_str());
+                return package_name;
+            }
+            LOGI("进程名 %s 没有对应的 base.apk 映射，改为从加载路径提取包名", package_name.c_str());
+        }
+        
+        std::shared_ptr<const ModuleIndex> index = refreshModuleIndex();
+        const ModuleInfo* self = index ? index->findByName("libcpp_shared.so") : nullptr;
+        if (!self) {
+            LOGE("未找到 libcpp_shared.so，无法提取包名");
+            return "";
+        }
+        package_name = extractPackageName(self->path);
+        LOGI("从路径提取包名: %s (路径: %s)", package_name.c_str(), self->path.c_str());
+        return package_name;
+    }
+    
+    static std::string readCmdline() {
+        char buffer[256];
+        int fd = open("/proc/self/cmdline", O_RDONLY | O_CLOEXEC);
+        if (fd < 0) return "";
+        ssize_t n = read(fd, buffer, sizeof(buffer) - 1);
+        close(fd);
+        if (n <= 0) return "";
+        buffer[n] = '\0';
+        
+        // argv[0] 到第一个 '\0'；去掉 ":remote" 之类的子进程后缀
+        std::string_view name(buffer, strnlen(buffer, size_t(n)));
+        name = name.substr(0, name.find(':'));
+        // 包名至少包含一个点，且不含 '/'（排除 app_process 等启动器路径）
+        if (name.find('.') == std::string_view::npos || name.find('/') != std::string_view::npos) {
+            return "";
+        }
+        return std::string(name);
+    }
+};
+
+// ============================
+// 从 base.apk 直接读取库信息
+// ============================
+// extractNativeLibs=false 打包的应用没有 lib/arm64/ 目录，库以 lib/arm64-v8a/*.so 条目留在 APK 中。
+// mmap 整个 APK，只解析中央目录与本地文件头：不解压、不复制。
+// 未压缩（STORED）且数据偏移按页对齐的条目可以被链接器直接从 APK 映射。
+class ApkArchive {
+public:
+    struct Entry {
+        std::string_view name;
+        uint64_t data_offset;       // 数据在 APK 中的偏移（本地文件头之后）
+        uint64_t compressed_size;
+        uint64_t size;              // 解压后大小
+        bool stored;                // 未压缩
+    };
+    
+    static std::optional<ApkArchive> open(const std::string& path) {
+        int fd = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+        if (fd < 0) {
+            LOGE("无法打开 APK: %s (%s)", path.c_str(), strerror(errno));
+            return std::nullopt;
+        }
+        struct stat st;
+        if (fstat(fd, &st) != 0 || st.st_size < kEocdSize) {
+            close(fd);
+            return std::nullopt;
+        }
+        void* data = mmap(nullptr, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+        if (data == MAP_FAILED) {
+            LOGE("无法映射 APK: %s (%s)", path.c_str(), strerror(errno));
+            close(fd);
+            return std::nullopt;
+        }
+        
+        ApkArchive archive(fd, static_cast<const uint8_t*>(data), size_t(st.st_size));
+        if (!archive.readCentralDirectory()) {
+            LOGE("APK 中央目录无效: %s", path.c_str());
+            return std::nullopt;
+        }
+        return archive;
+    }
+    
+    ApkArchive(ApkArchive&& other) noexcept
+        : fd_(std::exchange(other.fd_, -1)), data_(std::exchange(other.data_, nullptr)),
+          size_(other.size_), entries_(std::move(other.entries_)) {}
+    ApkArchive(const ApkArchive&) = delete;
+    ApkArchive& operator=(const ApkArchive&) = delete;
+    ApkArchive& operator=(ApkArchive&&) = delete;
+    
+    ~ApkArchive() {
+        if (data_) munmap(const_cast<uint8_t*>(data_), size_);
+        if (fd_ >= 0) close(fd_);
+    }
+    
+    int fd() const { return fd_; }
+    const std::vector<Entry>& entries() const { return entries_; }
+    
+private:
+    static constexpr uint32_t kEocdSignature = 0x06054b50;
+    static constexpr uint32_t kCentralSignature = 0x02014b50;
+    static constexpr uint32_t kLocalSignature = 0x04034b50;
+    static constexpr off_t kEocdSize = 22;
+    static constexpr size_t kCentralSize = 46;
+    static constexpr size_t kLocalSize = 30;
+    
+    ApkArchive(int fd, const uint8_t* data, size_t size) : fd_(fd), data_(data), size_(size) {}
+    
+    uint16_t read16(size_t offset) const { uint16_t v; memcpy(&v, data_ + offset, sizeof(v)); return v; }
+    uint32_t read32(size_t offset) const { uint32_t v; memcpy(&v, data_ + offset, sizeof(v)); return v; }
+    
+    bool readCentralDirectory() {
+        // EOCD 在文件末尾，之后最多跟 65535 字节注释
+        size_t eocd = SIZE_MAX;
+        size_t lowest = size_ > kEocdSize + 0xffff ? size_ - kEocdSize - 0xffff : 0;
+        for (size_t pos = size_ - kEocdSize + 1; pos-- > lowest;) {
+            if (read32(pos) == kEocdSignature) {
+                eocd = pos;
+                break;
+            }
+        }
+        if (eocd == SIZE_MAX) return false;
+        
+        uint16_t entry_count = read16(eocd + 10);
+        uint32_t cd_size = read32(eocd + 12);
+        uint32_t cd_offset = read32(eocd + 16);
+        if (entry_count == 0xffff || cd_offset == 0xffffffff) {
+            LOGE("APK 使用 ZIP64，暂不支持");
+            return false;
+        }
+        if (uint64_t(cd_offset) + cd_size > eocd) return false;
+        
+        entries_.reserve(entry_count);
+        size_t pos = cd_offset;
+        size_t end = size_t(cd_offset) + cd_size;
+        for (uint16_t i = 0; i < entry_count; ++i) {
+            if (end - pos < kCentralSize || read32(pos) != kCentralSignature) return false;
+            uint16_t method = read16(pos + 10);
+            uint32_t compressed_size = read32(pos + 20);
+            uint32_t size = read32(pos + 24);
+            uint16_t name_length = read16(pos + 28);
+            uint16_t extra_length = read16(pos + 30);
+            uint16_t comment_length = read16(pos + 32);
+            uint32_t local_offset = read32(pos + 42);
+            size_t next = pos + kCentralSize + name_length + extra_length + comment_length;
+            if (next > end) return false;
+            
+            // 数据偏移以本地文件头中的名称/扩展长度为准（对齐填充写在本地扩展字段里）
+            if (uint64_t(local_offset) + kLocalSize > cd_offset || read32(local_offset) != kLocalSignature) {
+                return false;
+            }
+            uint64_t data_offset = uint64_t(local_offset) + kLocalSize + read16(local_offset + 26) +
+                                   read16(local_offset + 28);
+            if (data_offset + compressed_size > cd_offset) return false;
+            
+            entries_.push_back({
+                std::string_view(reinterpret_cast<const char*>(data_ + pos + kCentralSize), name_length),
+                data_offset, compressed_size, size, method == 0 && compressed_size == size});
+            pos = next;
+        }
+        return true;
+    }
+    
+    int fd_;
+    const uint8_t* data_;
+    size_t size_;
+    std::vector<Entry> entries_;
+};
+
+// 列出 APK 中 abi_dir（如 "lib/arm64-v8a/"）下的 .so 条目；未压缩条目同时读取 ELF 元数据
+static std::vector<LibraryInfo> scanApkLibraries(const std::string& apk_path, std::string_view abi_dir) {
+    ProfileSpan span("scanApkLibraries");
+    std::vector<LibraryInfo> result;
+    
+    std::optional<ApkArchive> archive = ApkArchive::open(apk_path);
+    if (!archive) {
+        return result;
+    }
+    
+    const uint64_t page_size = uint64_t(sysconf(_SC_PAGESIZE));
+    for (const ApkArchive::Entry& entry : archive->entries()) {
+        if (entry.name.size() <= abi_dir.size() + 3 || entry.name.substr(0, abi_dir.size()) != abi_dir ||
+            entry.name.substr(entry.name.size() - 3) != ".so" ||
+            entry.name.find('/', abi_dir.size()) != std::string_view::npos) {
+            continue;
+        }
+        
+        LibraryInfo info;
+        info.name.assign(entry.name.substr(abi_dir.size()));
+        info.size = entry.size;
+        info.apk_offset = entry.data_offset;
+        info.apk_stored = entry.stored;
+        info.apk_page_aligned = entry.stored && entry.data_offset % page_size == 0;
+        if (entry.stored) {
+            readElfMetadata(archive->fd(), info, off_t(entry.data_offset));
+        }
+        result.push_back(std::move(info));
+    }
+    
+    LOGI("APK 中共 %zu 个条目，%.*s 下 %zu 个库", archive->entries().size(), int(abi_dir.size()), abi_dir.data(),
+         result.size());
+    return result;
+}
+
+// 扫描库目录，找到最大的库；库目录不存在（extractNativeLibs=false）时改为读取 APK 中的条目
+std::vector<LibraryInfo> libraries;
+std::string findLargestLibrary(const std::string& lib_dir, const std::string& apk_path) {
+    ProfileSpan span("findLargestLibrary");
+    // extractNativeLibs=false 时库目录不存在是正常情况，只有 APK 兜底也失败才报错
+    int dir_errno = 0;
+    if (!scanLibraryDirectory(lib_dir, &libraries)) {
+        dir_errno = errno;
+        LOGI("库目录不可用: %s (%s)", lib_dir.c_str(), strerror(dir_errno));
+    }
+    if (libraries.empty() && !apk_path.empty()) {
+        LOGI("库目录为空，从 APK 读取: %s", apk_path.c_str());
+        libraries = scanApkLibraries(apk_path, "lib/arm64-v8a/");
+    }
+    
+    for (const LibraryInfo& lib : libraries) {
+        LOGI("✓ 发现库: %s (大小: %zu 字节, e_machine=%u, 节区=%u, dynsym=%s)",
+             lib.name.c_str(), lib.size, lib.e_machine, lib.section_count,
+             lib.has_dynsym ? "有" : "无");
+        if (lib.apk_offset) {
+            LOGI("  APK 偏移: 0x%llx, %s%s", (unsigned long long)lib.apk_offset,
+                 lib.apk_stored ? "未压缩" : "已压缩", lib.apk_page_aligned ? ", 页对齐" : "");
+        }
+    }
+    
+    if (libraries.empty()) {
+        if (dir_errno) {
+            LOGE("无法打开库目录: %s (%s)，APK 中也没有 .so", lib_dir.c_str(), strerror(dir_errno));
+        }
+        LOGE("未找到任何 .so 库文件");
+        return "";
+    }
+    
+    // 找到最大的库
+    auto largest = std::max_element(libraries.begin(), libraries.end(),
+        [](const LibraryInfo& a, const LibraryInfo& b) {
+            return a.size < b.size;
+        });
+    
+    LOGI("最大库: %s (大小: %zu 字节)", largest->name.c_str(), largest->size);
+    return largest->name;
+}
+
+// 识别游戏引擎
+GameEngine identifyGameEngine(GumModule* module) {
+    ProfileSpan span("identifyGameEngine");
+    const gchar* module_name = gum_module_get_name(module);
+    std::string lower_name = module_name;
+    std::transform(lower_name.begin(), lower_name.end(), lower_name.begin(), ::tolower);
+    
+    if (lower_name.find("il2cpp") != std::string::npos || 
+        lower_name.find("unity") != std::string::npos) {
+        return GameEngine::UNITY;
+    }
+    
+    if (lower_name.find("ue4") != std::string::npos || 
+        lower_name.find("ue5") != std::string::npos ||
+        lower_name.find("unreal") != std::string::npos) {
+        return GameEngine::UNREAL;
+    }
+    
+    // ✅ 优化：通过文件名直接区分 Cocos2d-js 和 Cocos2d-x (C++)
+    // 避免两次耗时的符号枚举（从 500ms 降低到 < 1ms）
+    if (lower_name.find("cocos") != std::string::npos) {
+        // libcocos.so 和 libcocos2djs.so 归类为 Cocos2d-js
+        if (lower_name == "libcocos.so" || lower_name == "libcocos2djs.so") {
+            LOGI("根据文件名识别为 Cocos2d-js: %s", module_name);
+            return GameEngine::COCOS2D_JS;
+        }
+        
+        // 其他 cocos 相关库归类为 Cocos2d-x (C++)
+        LOGI("根据文件名识别为 Cocos2d-x (C++): %s", module_name);
+        return GameEngine::COCOS2D_CPP;
+    }
+    
+    if (lower_name.find("godot") != std::string::npos) {
+        return GameEngine::GODOT;
+    }
+    
+    return GameEngine::UNKNOWN;
+}
+
+// 获取引擎名称
+const char* getEngineName(GameEngine engine) {
+    switch (engine) {
+        case GameEngine::UNITY: return "Unity";
+        case GameEngine::UNREAL: return "Unreal Engine";
+        case GameEngine::COCOS2D_CPP: return "Cocos2d-x (C++)";
+        case GameEngine::COCOS2D_JS: return "Cocos2d-js (JavaScript)";
+        case GameEngine::GODOT: return "Godot";
+        default: return "Unknown";
+    }
+}
+
+// ============================
+// 模块加载监听（替代轮询）
+// ============================
+
+// 模块加载回调：module 为借用引用，回调内有效；需要长期持有请自行 g_object_ref
+using ModuleLoadCallback = std::function<void(GumModule* module)>;
+// 订阅回调：一次扫描发现的全部新模块（借用引用，同上）
+using ModuleBatchCallback = std::function<void(const std::vector<GumModule*>& modules)>;
+
+// 通过 Interceptor 挂接 dlopen / android_dlopen_ext，在加载完成的那一刻
+// 对新映射的 ELF 触发回调，而不是每隔一段时间调用 gum_process_find_module_by_name。
+// 按名称的 watch 在加载线程同步回调（需要赶在库被使用前装 Hook），只在有未触发的监听时枚举模块；
+// subscribe 的订阅者在后台分发线程回调，加载线程只负责唤醒，多次 dlopen 合并为一次枚举
+class ModuleWatcher {
+public:
+    static ModuleWatcher& instance() {
+        // 不析构：进程退出时分发线程可能仍在运行
+        static ModuleWatcher* watcher = new ModuleWatcher();
+        return *watcher;
+    }
+
+    // 监听指定名称的模块：已加载则立即在当前线程回调，
+    // 否则在其被加载（包括作为依赖被间接加载）时于加载线程回调。只触发一次。
+    // 返回监听编号（可交给 unwatch 取消），已立即回调时返回 0
+    uint64_t watch(const std::string& name, ModuleLoadCallback callback) {
+        ensureStarted();
+
+        // gum 查找模块会持有链接器锁，必须在 mutex_ 之外进行（见 onLibraryLoaded）
+        GumModule* module = gum_process_find_module_by_name(name.c_str());
+        if (module) {
+            callback(module);
+            g_object_unref(module);
+            return 0;
+        }
+
+        uint64_t id;
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            id = ++next_watch_id_;
+            pending_.push_back({id, name, std::move(callback)});
+        }
+
+        // 查找与登记之间模块可能恰好加载完成：再查一次，由成功摘下登记的一方负责回调
+        module = gum_process_find_module_by_name(name.c_str());
+        if (module) {
+            ModuleLoadCallback pending_callback;
+            if (takePending(id, &pending_callback)) {
+                pending_callback(module);
+                g_object_unref(module);
+                return 0;
+            }
+            g_object_unref(module);
+        }
+        return id;
+    }
+
+    // 取消尚未触发的监听；返回 false 表示回调已经（或正在）执行
+    bool unwatch(uint64_t id) {
+        return takePending(id, nullptr);
+    }
+
+    // 订阅此后新映射的 ELF（按基址判断，dlclose 后在新地址重新加载的库会再次通知）。
+    // 在后台分发线程回调，同一次扫描发现的模块合并为一批
+    void subscribe(ModuleBatchCallback callback) {
+        ensureStarted();
+        std::call_once(dispatch_once_, [this] {
+            std::thread(&ModuleWatcher::dispatchLoop, this).detach();
+        });
+
+        // 第一个订阅者以当前模块为基准；此后分发线程每次扫描都会更新基准
+        bool first;
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            first = subscribers_.empty();
+        }
+        std::vector<GumModule*> modules;
+        if (first) {
+            modules = snapshotModules();
+        }
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            if (subscribers_.empty()) {
+                known_bases_.clear();
+                for (GumModule* module : modules) {
+                    known_bases_.insert(gum_module_get_range(module)->base_address);
+                }
+            }
+            subscribers_.push_back(std::move(callback));
+        }
+        releaseModules(modules);
+    }
+
+    // 阻塞等待模块加载，timeout_ms < 0 表示无限等待
+    // 返回的模块需调用方 g_object_unref，超时返回 nullptr（此时监听已撤销，不会再持有模块引用）
+    GumModule* waitFor(const std::string& name, int timeout_ms) {
+        struct WaitState {
+            std::mutex mutex;
+            std::condition_variable cv;
+            GumModule* module = nullptr;
+            bool abandoned = false;     // 等待方已超时返回
+        };
+        auto state = std::make_shared<WaitState>();
+
+        uint64_t id = watch(name, [state](GumModule* module) {
+            std::lock_guard<std::mutex> lock(state->mutex);
+            if (!state->abandoned) {
+                state->module = GUM_MODULE(g_object_ref(module));
+                state->cv.notify_all();
+            }
+        });
+
+        std::unique_lock<std::mutex> lock(state->mutex);
+        auto ready = [&state] { return state->module != nullptr; };
+        if (timeout_ms < 0) {
+            state->cv.wait(lock, ready);
+        } else {
+            state->cv.wait_for(lock, std::chrono::milliseconds(timeout_ms), ready);
+        }
+        if (!state->module) {
+            // 之后即使回调仍在执行也不会再引用模块
+            state->abandoned = true;
+            lock.unlock();
+            unwatch(id);
+            return nullptr;
+        }
+        return state->module;
+    }
+
+private:
+    struct PendingWatch {
+        uint64_t id;
+        std::string name;
+        ModuleLoadCallback callback;
+    };
+
+    struct FiredCallback {
+        GumModule* module;
+        ModuleLoadCallback callback;
+    };
+
+    ModuleWatcher() = default;
+
+    // 枚举当前所有模块（持有引用）。gum 遍历链接器的模块列表时会持有链接器锁：
+    // 若此时还持有 mutex_，而另一个线程在库构造函数中 dlopen（已持有链接器锁）并进入 onLeave 等待 mutex_，
+    // 两者会互相等待。因此枚举一律在 mutex_ 之外完成，锁内只做比较与登记
+    static std::vector<GumModule*> snapshotModules() {
+        std::vector<GumModule*> modules;
+        gum_process_enumerate_modules(
+            [](GumModule* module, gpointer user_data) {
+                static_cast<std::vector<GumModule*>*>(user_data)->push_back(GUM_MODULE(g_object_ref(module)));
+                return (gboolean)TRUE;
+            },
+            &modules);
+        return modules;
+    }
+
+    static void releaseModules(std::vector<GumModule*>& modules) {
+        for (GumModule* module : modules) {
+            g_object_unref(module);
+        }
+        modules.clear();
+    }
+
+    void ensureStarted() {
+        std::call_once(start_once_, [this] {
+            GumInterceptor* interceptor = gum_interceptor_obtain();
+            listener_ = gum_make_call_listener(onEnter, onLeave, this, nullptr);
+
+            // System.loadLibrary 走 android_dlopen_ext，native 代码一般走 dlopen
+            const char* loader_functions[] = {"android_dlopen_ext", "dlopen"};
+            gum_interceptor_begin_transaction(interceptor);
+            for (const char* function_name : loader_functions) {
+                GumAddress address = gum_module_find_global_export_by_name(function_name);
+                if (address == 0) {
+                    LOGE("模块监听：未找到 %s", function_name);
+                    continue;
+                }
+                GumAttachReturn ret = gum_interceptor_attach(interceptor, GSIZE_TO_POINTER(address),
+                                                             listener_, nullptr, GUM_ATTACH_FLAGS_NONE);
+                if (ret == GUM_ATTACH_OK) {
+                    LOGI("✓ 模块监听已挂接 %s @ 0x%lx", function_name, address);
+                } else {
+                    LOGE("模块监听挂接 %s 失败: 错误码 %d", function_name, ret);
+                }
+            }
+            gum_interceptor_end_transaction(interceptor);
+        });
+    }
+
+    static void onEnter(GumInvocationContext* ic, gpointer user_data) {
+        // 记录本次调用的文件名，离开时用于日志
+        const char** filename = GUM_IC_GET_INVOCATION_DATA(ic, const char*);
+        *filename = static_cast<const char*>(gum_invocation_context_get_nth_argument(ic, 0));
+    }
+
+    static void onLeave(GumInvocationContext* ic, gpointer user_data) {
+        if (gum_invocation_context_get_return_value(ic) == nullptr) {
+            return;  // 加载失败
+        }
+        const char** filename = GUM_IC_GET_INVOCATION_DATA(ic, const char*);
+        static_cast<ModuleWatcher*>(user_data)->onLibraryLoaded(*filename);
+    }
+
+    void onLibraryLoaded(const char* filename) {
+        bool watching;
+        bool subscribed;
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            watching = !pending_.empty();
+            subscribed = !subscribers_.empty();
+            scan_requested_ = scan_requested_ || subscribed;
+        }
+        if (subscribed) {
+            dispatch_cv_.notify_one();
+        }
+        // 没有未触发的监听时加载线程不做任何枚举
+        if (!watching) {
+            return;
+        }
+
+        // 一次 dlopen 可能连带加载多个依赖：锁外枚举，锁内按名称摘下匹配的监听
+        std::vector<GumModule*> modules = snapshotModules();
+        std::vector<FiredCallback> fired;
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            for (GumModule* module : modules) {
+                collectPendingLocked(module, fired);
+            }
+        }
+        releaseModules(modules);
+
+        if (!fired.empty()) {
+            LOGD("dlopen(%s) 触发 %zu 个模块加载回调", filename ? filename : "(null)", fired.size());
+        }
+
+        // 回调在锁外执行，允许其中再次 watch 或调用 dlopen
+        for (FiredCallback& entry : fired) {
+            entry.callback(entry.module);
+            g_object_unref(entry.module);
+        }
+    }
+
+    // 分发线程：被 dlopen 唤醒后枚举一次模块，与上次的基址集合比较，新增的一批交给订阅者。
+    // 基准每次都整体替换，卸载的模块随之移出，之后重新加载仍会通知
+    void dispatchLoop() {
+        for (;;) {
+            {
+                std::unique_lock<std::mutex> lock(mutex_);
+                dispatch_cv_.wait(lock, [this] { return scan_requested_; });
+                scan_requested_ = false;
+            }
+
+            std::vector<GumModule*> modules = snapshotModules();
+            std::vector<GumModule*> added;
+            std::vector<ModuleBatchCallback> subscribers;
+            {
+                std::lock_guard<std::mutex> lock(mutex_);
+                std::unordered_set<GumAddress> bases;
+                bases.reserve(modules.size());
+                for (GumModule* module : modules) {
+                    GumAddress base = gum_module_get_range(module)->base_address;
+                    bases.insert(base);
+                    if (!known_bases_.count(base)) {
+                        added.push_back(module);
+                    }
+                }
+                known_bases_.swap(bases);
+                if (!added.empty()) {
+                    subscribers = subscribers_;
+                }
+            }
+
+            if (!added.empty()) {
+                LOGD("模块监听：新增 %zu 个模块，通知 %zu 个订阅者", added.size(), subscribers.size());
+                for (const ModuleBatchCallback& subscriber : subscribers) {
+                    subscriber(added);
+                }
+            }
+            releaseModules(modules);
+        }
+    }
+
+    bool takePending(uint64_t id, ModuleLoadCallback* callback) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        for (auto it = pending_.begin(); it != pending_.end(); ++it) {
+            if (it->id == id) {
+                if (callback) *callback = std::move(it->callback);
+                pending_.erase(it);
+                return true;
+            }
+        }
+        return false;
+    }
+
+    // watch 登记时模块尚未加载，所以此时同名模块一定是新加载的
+    void collectPendingLocked(GumModule* module, std::vector<FiredCallback>& fired) {
+        const char* name = gum_module_get_name(module);
+        for (auto it = pending_.begin(); it != pending_.end();) {
+            if (it->name == name) {
+                fired.push_back({GUM_MODULE(g_object_ref(module)), std::move(it->callback)});
+                it = pending_.erase(it);
+            } else {
+                ++it;
+            }
+        }
+    }
+
+    std::once_flag start_once_;
+    std::once_flag dispatch_once_;
+    std::mutex mutex_;
+    std::condition_variable dispatch_cv_;
+    bool scan_requested_ = false;
+    uint64_t next_watch_id_ = 0;
+    GumInvocationListener* listener_ = nullptr;
+    std::unordered_set<GumAddress> known_bases_;       // 订阅者已知模块的基址
+    std::vector<PendingWatch> pending_;
+    std::vector<ModuleBatchCallback> subscribers_;
+};
+
+// ============================
+// 符号索引（一次解析，多处共享）
+// ============================
+
+// Hook 目标符号 ID
+enum class SymbolTargetId : uint8_t {
+    SCHEDULER_UPDATE,         // cocos2d::Scheduler::update
+    SCRIPT_ENGINE_EVAL,       // se::ScriptEngine::evalString
+    JSON_DISPOSE,             // Json_dispose
+    COUNT
+};
+
+// 声明式目标表：每个 Hook 在此登记模式（"A.*B" 表示 A 之后出现 B，大小写敏感）
+struct SymbolTarget {
+    SymbolTargetId id;
+    const char* pattern;
+};
+
+static const SymbolTarget kSymbolTargets[] = {
+    {SymbolTargetId::SCHEDULER_UPDATE,   "Scheduler.*update"},
+    {SymbolTargetId::SCRIPT_ENGINE_EVAL, "ScriptEngine.*evalString"},
+    {SymbolTargetId::JSON_DISPOSE,       "Json_dispose"},
+};
+
+// 多模式符号匹配器：把所有模式的字面片段编译进一个 Aho-Corasick 自动机（稠密 DFA），
+// 对 '\0' 分隔的字符串表做一次线性扫描，报告每个命中及其模式编号
+class SymbolMatcher {
+public:
+    explicit SymbolMatcher(const std::vector<std::string_view>& patterns) {
+        nodes_.emplace_back();
+        nodes_[0].next.fill(-1);
+        fragment_counts_.reserve(patterns.size());
+
+        for (uint32_t p = 0; p < patterns.size(); ++p) {
+            uint16_t fragment_index = 0;
+            std::string_view pattern = patterns[p];
+            size_t pos = 0;
+            while (pos <= pattern.size()) {
+                size_t next = pattern.find(".*", pos);
+                size_t end = next == std::string_view::npos ? pattern.size() : next;
+                if (end > pos) {
+                    addFragment(pattern.substr(pos, end - pos), p, fragment_index++);
+                }
+                if (next == std::string_view::npos) break;
+                pos = next + 2;
+            }
+            fragment_counts_.push_back(fragment_index);
+        }
+
+        buildFailureLinks();
+    }
+
+    size_t patternCount() const { return fragment_counts_.size(); }
+
+    // 扫描字符串表，on_hit(symbol_ordinal, pattern_index) 对每个 (符号, 模式) 命中调用一次
+    // 回调返回 false 时提前结束
+    template <typename OnHit>
+    void scan(std::string_view names, OnHit&& on_hit) const {
+        const size_t pattern_count = fragment_counts_.size();
+        // 每个模式在当前符号中已匹配的片段数及最后匹配结束位置；用 generation 代替逐符号清零
+        std::vector<uint16_t> progress(pattern_count, 0);
+        std::vector<uint32_t> last_end(pattern_count, 0);
+        std::vector<uint32_t> generation(pattern_count, UINT32_MAX);
+
+        uint32_t ordinal = 0;
+        uint32_t symbol_start = 0;
+        int32_t state = 0;
+
+        for (uint32_t i = 0; i < names.size(); ++i) {
+            unsigned char c = static_cast<unsigned char>(names[i]);
+            if (c == 0) {
+                ++ordinal;
+                symbol_start = i + 1;
+                state = 0;
+                continue;
+            }
+
+            state = nodes_[state].next[c];
+            for (const Output& out : nodes_[state].outputs) {
+                uint32_t p = out.pattern;
+                if (generation[p] != ordinal) {
+                    generation[p] = ordinal;
+                    progress[p] = 0;
+                    last_end[p] = symbol_start;
+                }
+                // 片段需按顺序出现且互不重叠；按结束位置递增处理即为贪心最早匹配
+                if (progress[p] != out.fragment || i + 1 - out.length < last_end[p]) {
+                    continue;
+                }
+                last_end[p] = i + 1;
+                if (++progress[p] == fragment_counts_[p]) {
+                    if (!on_hit(ordinal, p)) return;
+                }
+            }
+        }
+    }
+
+private:
+    struct Output {
+        uint32_t pattern;
+        uint16_t fragment;
+        uint16_t length;
+    };
+
+    struct Node {
+        std::array<int32_t, 256> next;
+        int32_t fail = 0;
+        std::vector<Output> outputs;
+    };
+
+    void addFragment(std::string_view fragment, uint32_t pattern, uint16_t fragment_index) {
+        int32_t state = 0;
+        for (char ch : fragment) {
+            unsigned char c = static_cast<unsigned char>(ch);
+            if (nodes_[state].next[c] < 0) {
+                nodes_[state].next[c] = static_cast<int32_t>(nodes_.size());
+                nodes_.emplace_back();
+                nodes_.back().next.fill(-1);
+            }
+            state = nodes_[state].next[c];
+        }
+        nodes_[state].outputs.push_back({pattern, fragment_index, static_cast<uint16_t>(fragment.size())});
+    }
+
+    // BFS 计算失败链接并补全为 DFA 转移；输出沿失败链接合并
+    void buildFailureLinks() {
+        std::vector<int32_t> queue;
+        queue.reserve(nodes_.size());
+        for (int c = 0; c < 256; ++c) {
+            int32_t child = nodes_[0].next[c];
+            if (child < 0) {
+                nodes_[0].next[c] = 0;
+            } else {
+                nodes_[child].fail = 0;
+                queue.push_back(child);
+            }
+        }
+        for (size_t head = 0; head < queue.size(); ++head) {
+            int32_t state = queue[head];
+            const std::vector<Output>& inherited = nodes_[nodes_[state].fail].outputs;
+            nodes_[state].outputs.insert(nodes_[state].outputs.end(), inherited.begin(), inherited.end());
+            for (int c = 0; c < 256; ++c) {
+                int32_t child = nodes_[state].next[c];
+                int32_t fallback = nodes_[nodes_[state].fail].next[c];
+                if (child < 0) {
+                    nodes_[state].next[c] = fallback;
+                } else {
+                    nodes_[child].fail = fallback;
+                    queue.push_back(child);
+                }
+            }
+        }
+    }
+
+    std::vector<Node> nodes_;
+    std::vector<uint16_t> fragment_counts_;
+};
+
+struct SymbolEntry {
+    uint32_t name_offset;   // 在字符串表中的偏移
+    uint32_t name_length;
+    GumAddress address;
+};
+
+// 模块导出符号索引：通过 GumElfModule 一次性解析 .dynsym，
+// 名称连续存放于驻留字符串表（'\0' 分隔，保持 .dynsym 顺序），
+// 支持 O(1) 精确查找、前缀查找与单次遍历的批量模式查询
+class SymbolIndex {
+public:
+    // 获取模块的共享索引（按模块路径缓存，首次调用时构建）
+    static std::shared_ptr<const SymbolIndex> forModule(GumModule* module) {
+        static std::mutex cache_mutex;
+        static std::unordered_map<std::string, std::shared_ptr<const SymbolIndex>> cache;
+
+        std::lock_guard<std::mutex> lock(cache_mutex);
+        std::string path = gum_module_get_path(module);
+        auto it = cache.find(path);
+        if (it != cache.end()) {
+            return it->second;
+        }
+
+        ProfileSpan span("SymbolIndex::build");
+        auto index = std::make_shared<SymbolIndex>();
+        index->build(module);
+        LOGI("符号索引: %s 共 %zu 个导出符号, 字符串表 %zu 字节, 目标命中 %zu 个",
+             gum_module_get_name(module), index->size(), index->names_.size(),
+             index->all_target_hits_.size());
+        cache.emplace(std::move(path), index);
+        return index;
+    }
+
+    size_t size() const { return entries_.size(); }
+
+    // 按 .dynsym 顺序排列的条目
+    const std::vector<SymbolEntry>& entries() const { return entries_; }
+
+    // 字符串表（条目名称依次以 '\0' 分隔）
+    std::string_view names() const { return names_; }
+
+    std::string_view name(const SymbolEntry& entry) const {
+        return std::string_view(names_.data() + entry.name_offset, entry.name_length);
+    }
+
+    // 名称在字符串表中以 '\0' 结尾，可直接作为 C 字符串使用
+    const char* cName(const SymbolEntry& entry) const {
+        return names_.data() + entry.name_offset;
+    }
+
+    // 精确查找，未找到返回 nullptr
+    const SymbolEntry* find(std::string_view symbol_name) const {
+        auto it = lookup_.find(symbol_name);
+        return it != lookup_.end() ? &entries_[it->second] : nullptr;
+    }
+
+    GumAddress findAddress(std::string_view symbol_name) const {
+        const SymbolEntry* entry = find(symbol_name);
+        return entry ? entry->address : 0;
+    }
+
+    // 前缀查找：返回所有以 prefix 开头的条目（按名称排序）
+    std::vector<const SymbolEntry*> findPrefix(std::string_view prefix) const {
+        std::vector<const SymbolEntry*> result;
+        auto it = std::lower_bound(by_name_.begin(), by_name_.end(), prefix,
+            [this](uint32_t idx, std::string_view key) { return name(entries_[idx]) < key; });
+        for (; it != by_name_.end(); ++it) {
+            std::string_view candidate = name(entries_[*it]);
+            if (candidate.substr(0, prefix.size()) != prefix) break;
+            result.push_back(&entries_[*it]);
+        }
+        return result;
+    }
+
+    // 目标表中某个 Hook 的首个命中（.dynsym 顺序），未命中返回 nullptr
+    const SymbolEntry* target(SymbolTargetId id) const {
+        return target_hits_[static_cast<size_t>(id)];
+    }
+
+    // 全部命中：(目标 ID, 条目)，同一目标可能命中多个符号
+    const std::vector<std::pair<SymbolTargetId, const SymbolEntry*>>& targetHits() const {
+        return all_target_hits_;
+    }
+
+    // 批量模式查询：一次扫描字符串表，返回每个模式在 .dynsym 顺序下的首个命中（未命中为 nullptr）
+    std::vector<const SymbolEntry*> findFirstMatches(const std::vector<std::string_view>& patterns) const {
+        std::vector<const SymbolEntry*> result(patterns.size(), nullptr);
+        size_t remaining = patterns.size();
+        SymbolMatcher matcher(patterns);
+        matcher.scan(names_, [&](uint32_t ordinal, uint32_t p) {
+            if (!result[p]) {
+                result[p] = &entries_[ordinal];
+                --remaining;
+            }
+            return remaining != 0;
+        });
+        return result;
+    }
+
+private:
+    void build(GumModule* module) {
+        const GumMemoryRange* range = gum_module_get_range(module);
+        GError* error = nullptr;
+        GumElfModule* elf = gum_elf_module_new_from_memory(gum_module_get_path(module),
+                                                           range->base_address, &error);
+        if (elf) {
+            gum_elf_module_enumerate_dynamic_symbols(elf,
+                [](const GumElfSymbolDetails* details, gpointer user_data) {
+                    // 只收录已定义的全局/弱函数与对象
+                    if (details->shdr_index == SHN_UNDEF || details->address == 0) {
+                        return (gboolean)TRUE;
+                    }
+                    if (details->bind != GUM_ELF_BIND_GLOBAL && details->bind != GUM_ELF_BIND_WEAK) {
+                        return (gboolean)TRUE;
+                    }
+                    if (details->type != GUM_ELF_SYMBOL_FUNC && details->type != GUM_ELF_SYMBOL_OBJECT) {
+                        return (gboolean)TRUE;
+                    }
+                    static_cast<SymbolIndex*>(user_data)->append(details->name, details->address);
+                    return (gboolean)TRUE;
+                },
+                this);
+            g_object_unref(elf);
+        } else {
+            // 回退到 Gum 通用导出枚举
+            LOGE("GumElfModule 解析失败 (%s)，回退到导出枚举", error ? error->message : "unknown");
+            g_clear_error(&error);
+            gum_module_enumerate_exports(module,
+                [](const GumExportDetails* details, gpointer user_data) {
+                    static_cast<SymbolIndex*>(user_data)->append(details->name, details->address);
+                    return (gboolean)TRUE;
+                },
+                this);
+        }
+
+        finalize();
+    }
+
+    void append(const char* symbol_name, GumAddress address) {
+        size_t length = strlen(symbol_name);
+        if (length == 0) return;
+        entries_.push_back({static_cast<uint32_t>(names_.size()), static_cast<uint32_t>(length), address});
+        names_.append(symbol_name, length + 1);  // 保留结尾 '\0'
+    }
+
+    // 去除重名符号（只保留首个）并压缩字符串表，使第 N 个名称恰好对应 entries_[N]；
+    // 字符串表构建完成后再建立视图，避免扩容使视图失效
+    void finalize() {
+        std::unordered_set<std::string_view> seen;
+        seen.reserve(entries_.size());
+        std::string compact;
+        compact.reserve(names_.size());
+        std::vector<SymbolEntry> unique;
+        unique.reserve(entries_.size());
+        for (const SymbolEntry& entry : entries_) {
+            if (seen.insert(name(entry)).second) {
+                unique.push_back({static_cast<uint32_t>(compact.size()), entry.name_length, entry.address});
+                compact.append(cName(entry), entry.name_length + 1);
+            }
+        }
+        seen.clear();
+        names_.swap(compact);
+        entries_.swap(unique);
+
+        lookup_.reserve(entries_.size());
+        for (uint32_t i = 0; i < entries_.size(); ++i) {
+            lookup_.emplace(name(entries_[i]), i);
+        }
+
+        by_name_.resize(entries_.size());
+        for (uint32_t i = 0; i < by_name_.size(); ++i) by_name_[i] = i;
+        std::sort(by_name_.begin(), by_name_.end(),
+            [this](uint32_t a, uint32_t b) { return name(entries_[a]) < name(entries_[b]); });
+
+        resolveTargets();
+    }
+
+    // 目标表中全部模式共用一个自动机，对字符串表只扫描一次
+    void resolveTargets() {
+        static const SymbolMatcher matcher = [] {
+            std::vector<std::string_view> patterns;
+            for (const SymbolTarget& target : kSymbolTargets) patterns.push_back(target.pattern);
+            return SymbolMatcher(patterns);
+        }();
+
+        target_hits_.fill(nullptr);
+        matcher.scan(names_, [this](uint32_t ordinal, uint32_t p) {
+            SymbolTargetId id = kSymbolTargets[p].id;
+            const SymbolEntry* entry = &entries_[ordinal];
+            all_target_hits_.emplace_back(id, entry);
+            if (!target_hits_[static_cast<size_t>(id)]) {
+                target_hits_[static_cast<size_t>(id)] = entry;
+            }
+            return true;
+        });
+    }
+
+    std::string names_;
+    std::vector<SymbolEntry> entries_;
+    std::vector<uint32_t> by_name_;
+    std::unordered_map<std::string_view, uint32_t> lookup_;
+    std::array<const SymbolEntry*, static_cast<size_t>(SymbolTargetId::COUNT)> target_hits_{};
+    std::vector<std::pair<SymbolTargetId, const SymbolEntry*>> all_target_hits_;
+};
+
+// ============================
+// 启动任务图
+// ============================
+
+// 小型依赖图调度器：每个任务声明依赖，依赖全部成功后提交到线程池执行，
+// 互不依赖的分支并发运行。任务返回 false（或依赖被跳过）时，其后继任务全部跳过。
+class TaskGraph {
+public:
+    using TaskId = size_t;
+    
+    TaskId add(const char* name, std::initializer_list<TaskId> deps, std::function<bool()> fn) {
+        TaskId id = tasks_.size();
+        tasks_.push_back({name, std::move(fn), {}, deps.size(), false});
+        for (TaskId dep : deps) {
+            tasks_[dep].dependents.push_back(id);
+        }
+        return id;
+    }
+    
+    // 阻塞到所有任务完成或被跳过；返回成功执行的任务数
+    size_t run(WorkerPool& pool) {
+        std::unique_lock<std::mutex> lock(mutex_);
+        remaining_ = tasks_.size();
+        for (TaskId id = 0; id < tasks_.size(); ++id) {
+            if (tasks_[id].pending == 0) {
+                submit(pool, id);
+            }
+        }
+        cv_.wait(lock, [this] { return remaining_ == 0; });
+        return succeeded_;
+    }
+    
+private:
+    struct Task {
+        const char* name;
+        std::function<bool()> fn;
+        std::vector<TaskId> dependents;
+        size_t pending;                 // 未完成的依赖数
+        bool skipped;                   // 有依赖失败或被跳过
+    };
+    
+    void submit(WorkerPool& pool, TaskId id) {
+        pool.submit([this, &pool, id] {
+            bool ok;
+            {
+                ProfileSpan span(tasks_[id].name);
+                ok = tasks_[id].fn();
+            }
+            std::lock_guard<std::mutex> lock(mutex_);
+            if (ok) {
+                succeeded_++;
+            } else {
+                LOGE("启动任务失败: %s", tasks_[id].name);
+            }
+            finishLocked(pool, id, ok);
+        });
+    }
+    
+    void finishLocked(WorkerPool& pool, TaskId id, bool ok) {
+        for (TaskId next : tasks_[id].dependents) {
+            Task& task = tasks_[next];
+            task.skipped |= !ok;
+            if (--task.pending > 0) continue;
+            if (task.skipped) {
+                LOGI("跳过启动任务: %s", task.name);
+                finishLocked(pool, next, false);
+            } else {
+                submit(pool, next);
+            }
+        }
+        if (--remaining_ == 0) {
+            cv_.notify_all();
+        }
+    }
+    
+    std::vector<Task> tasks_;
+    std::mutex mutex_;
+    std::condition_variable cv_;
+    size_t remaining_ = 0;
+    size_t succeeded_ = 0;
+};
+
+// 全局加速倍率
+static float g_speed_multiplier = 4.0f;
+
+// Cocos2d-js 相关全局变量
+static int mycount = 100;                  // JS 调用计数器
+static std::string g_pkg;                // 全局包名（READY_PACKAGE 之后只读）
+
+// ============================
+// 启动就绪状态
+// ============================
+// 构造函数只启动工作线程，gum 初始化与包名解析都在工作线程上完成。
+// 依赖这些状态的代码按需查询或等待对应位，不依赖的路径不受影响。
+enum ReadyBits : uint32_t {
+    READY_GUM = 1u << 0,        // gum_init_embedded 完成
+    READY_PACKAGE = 1u << 1,    // g_pkg 已设置
+    READY_STARTUP = 1u << 2,    // workerThread 结束（无论成功与否）
+};
+
+class Readiness {
 public:
-    Timer(const char* operation_name) : name(operation_name) {
-        start_time = std::chrono::high_resolution_clock::now();
+    bool isReady(uint32_t bits) const {
+        return (bits_.load(std::memory_order_acquire) & bits) == bits;
     }
     
-    ~Timer() {
-        auto end_time = std::chrono::high_resolution_clock::now();
-        auto duration = std::chrono::duration_cast<std::chrono::milliseconds>(end_time - start_time);
-        LOGI("⏱️ [%s] 耗时: %lld ms", name, (long long)duration.count());
+    void mark(uint32_t bits) {
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            bits_.fetch_or(bits, std::memory_order_release);
+        }
+        cv_.notify_all();
     }
     
-    // 手动输出中间耗时（不销毁计时器）
-    void checkpoint(const char* checkpoint_name) {
-        auto now = std::chrono::high_resolution_clock::now();
-        auto duration = std::chrono::duration_cast<std::chrono::milliseconds>(now - start_time);
-        LOGI("⏱️ [%s -> %s] 耗时: %lld ms", name, checkpoint_name, (long long)duration.count());
+    // timeout_ms < 0 表示一直等待；返回是否就绪
+    bool waitFor(uint32_t bits, int timeout_ms) {
+        if (isReady(bits)) return true;
+        std::unique_lock<std::mutex> lock(mutex_);
+        auto ready = [&] { return isReady(bits); };
+        if (timeout_ms < 0) {
+            cv_.wait(lock, ready);
+            return true;
+        }
+        return cv_.wait_for(lock, std::chrono::milliseconds(timeout_ms), ready);
     }
+    
+private:
+    std::atomic<uint32_t> bits_{0};
+    std::mutex mutex_;
+    std::condition_variable cv_;
 };
 
+static Readiness g_readiness;
 
-// 游戏引擎类型
-enum class GameEngine {
-    UNKNOWN,
-    UNITY,
-    UNREAL,
-    COCOS2D_CPP,   // Cocos2d-x (C++ 版本)
-    COCOS2D_JS,    // Cocos2d-js (JavaScript 版本)
-    GODOT
-};
-
-// 库信息映射表
-using LibraryMap = std::unordered_map<std::string, std::string>;
-
-// 从路径中提取库名称
-std::string extractLibraryName(const std::string& path) {
-    size_t last_slash = path.rfind('/');
-    if (last_slash == std::string::npos) return path;
-    return path.substr(last_slash + 1);
-}
-
-// 读取 /proc/self/maps 获取私有库映射
-LibraryMap parseMaps() {
-    Timer timer("parseMaps");  // ⏱️ 计时开始
-    LibraryMap library_map;
-    std::ifstream maps_file("/proc/self/maps");
+// ============================
+// JSON 对象 → 原始字符串 映射表
+// ============================
+// Json_create/Json_dispose 可能在任意线程上调用：按对象指针分为多个分片，每个分片单独加锁。
+// 字符串放在分片自有的分级 slab 中（64B ~ 64KB，按 2 的幂分级），释放时挂回同级空闲链表复用。
+// 分片内存到达上限后只记录长度不复制内容；条目数到达上限时淘汰任意旧条目（Json_dispose 未 Hook 时防止无限增长）。
+class JsonStringTable {
+public:
+    static constexpr size_t kMaxLength = 50000;             // 超过的不记录（最多检查 50KB）
     
-    if (!maps_file.is_open()) {
-        LOGE("无法打开 /proc/self/maps");
-        return library_map;
+    // 记录对象对应的字符串，返回是否保存了内容
+    bool insert(void* key, const char* str, size_t length) {
+        Shard& shard = shardFor(key);
+        std::lock_guard<std::mutex> lock(shard.mutex);
+        
+        auto [it, inserted] = shard.entries.try_emplace(key);
+        if (!inserted) {
+            shard.release(it->second);
+        } else if (shard.entries.size() > kMaxEntriesPerShard) {
+            auto victim = shard.entries.begin();
+            if (victim == it) ++victim;
+            shard.release(victim->second);
+            shard.entries.erase(victim);
+        }
+        
+        Entry& entry = it->second;
+        entry.length = static_cast<uint32_t>(length);
+        entry.size_class = sizeClassFor(length + 1);
+        entry.data = shard.allocate(entry.size_class);
+        if (entry.data) {
+            memcpy(entry.data, str, length);
+            entry.data[length] = '\0';
+        }
+        return entry.data != nullptr;
     }
     
-    std::string line;
-    while (std::getline(maps_file, line)) {
-        // 查找包含 data/app 或 data/data 的路径
-        if (line.find("data/") != std::string::npos  ) {
-            
-            // maps 格式：address perms offset dev inode pathname
-            size_t path_start = line.rfind(' ');
-            if (path_start != std::string::npos) {
-                std::string full_path = line.substr(path_start + 1);
-                
-                // 提取库名称
-                std::string lib_name = extractLibraryName(full_path);
-                
-                // 记录 .so 文件和 base.apk
-                if (lib_name.find(".so") != std::string::npos || 
-                    lib_name.find("base.apk") != std::string::npos) {
-                    library_map[lib_name] = full_path;
-                }
-            }
+    // 删除对象的记录，返回是否存在
+    bool erase(void* key) {
+        Shard& shard = shardFor(key);
+        std::lock_guard<std::mutex> lock(shard.mutex);
+        auto it = shard.entries.find(key);
+        if (it == shard.entries.end()) {
+            return false;
         }
+        shard.release(it->second);
+        shard.entries.erase(it);
+        return true;
     }
     
-    maps_file.close();
-    LOGI("解析 maps，共找到 %zu 个私有库", library_map.size());
-    return library_map;
-}
-
-// 从路径中提取包名
-std::string extractPackageName(const std::string& path) {
-    // 格式1：/data/data/com.game.pkg/files/libcpp_shared.so
-    //        提取：com.game.pkg
-    // 格式2：/data/app/~~xxx/com.sqw.jwdzg.jwdzg_ptzy-xxx==/lib/arm64/libcpp_shared.so
-    //        提取：com.sqw.jwdzg.jwdzg_ptzy
- 
-    // 尝试格式1：/data/data/包名/files/...
-    // ✅ 优化：通过 /files/ 定位，向前提取包名
-    size_t files_pos = path.find("/files/");
-    if (files_pos != std::string::npos) {
-        // files_pos 本身就是 /files/ 前面的 '/'
-        size_t pkg_end = files_pos;
-        
-        // 向前找到包名起始位置的 '/'（/data/data/ 后面）
-        size_t pkg_start = path.rfind('/', pkg_end - 1);
-        if (pkg_start != std::string::npos) {
-            std::string package_name = path.substr(pkg_start + 1, pkg_end - pkg_start - 1);
-            
-            // 验证是否为有效包名（至少包含一个点）
-            if (package_name.find('.') != std::string::npos) {
-                return package_name;
-            }
+    // 在分片锁内访问记录：fn(内容（未保存时为 nullptr，否则以 '\0' 结尾）, 长度)
+    template <typename Visit>
+    bool visit(void* key, Visit&& fn) {
+        Shard& shard = shardFor(key);
+        std::lock_guard<std::mutex> lock(shard.mutex);
+        auto it = shard.entries.find(key);
+        if (it == shard.entries.end()) {
+            return false;
         }
+        fn(reinterpret_cast<const char*>(it->second.data), size_t(it->second.length));
+        return true;
     }
     
-    // 尝试格式2和格式3：/data/app/ 路径
-    // 格式2：/data/app/~~xxx/包名-xxx==/
-    // 格式3：/data/app/包名-xxx==/（直接包名，无 ~~xxx/ 前缀）
-    // /data/app/bin.mt.plus-1/base.apk
-    size_t data_pos = path.find("/data/app/");
-    if (data_pos != std::string::npos) {
-        // ✅ 一步式实现：先切割再提取 (getgamepkg 方式)
-        // 1. 找到最后一个 '-' 并截取之前的部分
-        std::string beforeDash = path.substr(0, path.find_last_of('-'));
+private:
+    static constexpr size_t kShardCount = 16;
+    static constexpr size_t kMinClassShift = 6;              // 64B
+    static constexpr size_t kClassCount = 11;                // 64B ~ 64KB
+    static constexpr size_t kChunkSize = size_t(1) << (kMinClassShift + kClassCount - 1);
+    static constexpr size_t kShardBudget = 512 * 1024;      // 每个分片的 slab 上限（总计 8MB）
+    static constexpr size_t kMaxEntriesPerShard = 4096;
+    static_assert(kMaxLength < kChunkSize, "最大级别必须能容纳 kMaxLength");
+    
+    struct Entry {
+        uint8_t* data = nullptr;
+        uint32_t length = 0;
+        uint8_t size_class = 0;
+    };
+    
+    struct alignas(64) Shard {
+        std::mutex mutex;
+        std::unordered_map<void*, Entry> entries;
+        std::vector<std::unique_ptr<uint8_t[]>> chunks;
+        uint8_t* bump = nullptr;                             // 当前 chunk 的未分配部分
+        size_t bump_left = 0;
+        std::array<uint8_t*, kClassCount> free_lists = {};   // 空闲块以首 8 字节链接
         
-        // 2. 找到最后一个 '/' 并提取包名部分
-        size_t lastSlash = beforeDash.find_last_of('/');
-        if (lastSlash != std::string::npos) {
-            std::string tpkg = beforeDash.substr(lastSlash + 1);
-            
-            // 3. 再次去除第一个 '-' 后的内容（去除包名中的版本后缀）
-            std::string package_name = tpkg.substr(0, tpkg.find("-"));
-            
-            // 验证是否为有效包名（至少包含一个点）
-            if (package_name.find('.') != std::string::npos) {
-                return package_name;
+        uint8_t* allocate(uint8_t size_class) {
+            uint8_t*& head = free_lists[size_class];
+            if (head) {
+                uint8_t* block = head;
+                memcpy(&head, block, sizeof(head));
+                return block;
+            }
+            size_t size = size_t(1) << (kMinClassShift + size_class);
+            if (bump_left < size) {
+                if ((chunks.size() + 1) * kChunkSize > kShardBudget) {
+                    return nullptr;
+                }
+                // 旧 chunk 的剩余部分按从大到小拆入空闲链表
+                for (uint8_t c = kClassCount; c-- > 0 && bump_left > 0;) {
+                    size_t piece = size_t(1) << (kMinClassShift + c);
+                    while (bump_left >= piece) {
+                        memcpy(bump, &free_lists[c], sizeof(uint8_t*));
+                        free_lists[c] = bump;
+                        bump += piece;
+                        bump_left -= piece;
+                    }
+                }
+                chunks.emplace_back(new uint8_t[kChunkSize]);
+                bump = chunks.back().get();
+                bump_left = kChunkSize;
+            }
+            uint8_t* block = bump;
+            bump += size;
+            bump_left -= size;
+            return block;
+        }
+        
+        void release(Entry& entry) {
+            if (entry.data) {
+                memcpy(entry.data, &free_lists[entry.size_class], sizeof(uint8_t*));
+                free_lists[entry.size_class] = entry.data;
+                entry.data = nullptr;
             }
         }
+    };
+    
+    static uint8_t sizeClassFor(size_t size) {
+        size_t shift = kMinClassShift;
+        while ((size_t(1) << shift) < size) shift++;
+        return static_cast<uint8_t>(shift - kMinClassShift);
     }
     
-    return "";
-}
+    Shard& shardFor(void* key) {
+        uintptr_t value = reinterpret_cast<uintptr_t>(key);
+        return shards_[((value >> 4) ^ (value >> 12)) % kShardCount];
+    }
+    
+    std::array<Shard, kShardCount> shards_;
+};
+
+// JSON 对象指针 → 原始字符串 映射表
+static JsonStringTable g_json_strings;
 
-// 根据包名查找 base.apk 路径
-std::string findBaseApkPath(const LibraryMap& library_map, const std::string& package_name) {
-    Timer timer("findBaseApkPath");  // ⏱️ 计时开始
-    if (package_name.empty()) return "";
+// ============================
+// 捕获文件写入
+// ============================
+// 网络请求/响应、Lua chunk 与 evalString 源码统一写入 cache/capture.fgc（格式见 capture_format.h）。
+// 调用线程只把记录复制一次入队；后台线程攒满一块后用 zlib 压缩追加，并重写索引尾。
+// 队列超过预算时丢弃并计数。
+class CaptureWriter {
+public:
+    static CaptureWriter& instance() {
+        // 不析构：进程退出时后台线程可能仍在运行
+        static CaptureWriter* writer = new CaptureWriter();
+        return *writer;
+    }
     
-    LOGI("开始查找包含 '%s' 和 'base.apk' 的路径", package_name.c_str());
+    bool enabled(CaptureKind kind) const {
+        return (mask_.load(std::memory_order_relaxed) >> kind) & 1;
+    }
     
-    // ✅ 优化：使用正则表达式匹配路径（格式：.../包名.../base.apk...）
-    std::string pattern_str = ".*" + package_name + ".*base\\.apk";
-    std::regex apk_pattern(pattern_str);
+    // 按位开关各类记录（bit = CaptureKind）
+    void setMask(uint32_t mask) { mask_.store(mask, std::memory_order_relaxed); }
     
-    for (const auto& [lib_name, lib_path] : library_map) {
-        // 使用正则表达式一次性匹配包名和 base.apk
-        std::smatch match;
-        if (std::regex_search(lib_path, match, apk_pattern)) {
-            LOGI("找到匹配路径: %s", lib_path.c_str());
-            
-            // 提取 base.apk 路径（截断到 base.apk）
-            size_t apk_pos = lib_path.find("base.apk");
-            if (apk_pos != std::string::npos) {
-                std::string result = lib_path.substr(0, apk_pos + std::strlen("base.apk"));
-                LOGI("✓ APK 路径: %s", result.c_str());
-                return result;
+    void setEnabled(CaptureKind kind, bool enabled) {
+        if (enabled) {
+            mask_.fetch_or(1u << kind, std::memory_order_relaxed);
+        } else {
+            mask_.fetch_and(~(1u << kind), std::memory_order_relaxed);
+        }
+    }
+    
+    // 内容由多段拼接，段之间以 '\0' 分隔
+    bool append(CaptureKind kind, std::string_view name, std::initializer_list<std::string_view> parts) {
+        if (!enabled(kind)) {
+            return false;
+        }
+        name = name.substr(0, UINT16_MAX);
+        size_t payload_length = parts.size() > 0 ? parts.size() - 1 : 0;
+        for (std::string_view part : parts) {
+            payload_length += part.size();
+        }
+        if (payload_length > kMaxPayload) {
+            countDropped();
+            return false;
+        }
+        
+        CaptureRecordHeader header = {};
+        header.kind = kind;
+        header.name_length = static_cast<uint16_t>(name.size());
+        header.payload_length = static_cast<uint32_t>(payload_length);
+        header.timestamp_ns = logTimestampNs(CLOCK_REALTIME);
+        
+        size_t record_size = sizeof(header) + name.size() + payload_length;
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            if (pending_bytes_ + record_size > kMaxPendingBytes) {
+                dropped_++;
+                return false;
             }
+            pending_bytes_ += record_size;
         }
+        
+        std::vector<uint8_t> record(record_size);
+        uint8_t* out = record.data();
+        memcpy(out, &header, sizeof(header));
+        out += sizeof(header);
+        memcpy(out, name.data(), name.size());
+        out += name.size();
+        bool first = true;
+        for (std::string_view part : parts) {
+            if (!first) *out++ = '\0';
+            memcpy(out, part.data(), part.size());
+            out += part.size();
+            first = false;
+        }
+        
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            pending_.push_back(std::move(record));
+        }
+        cv_.notify_one();
+        return true;
     }
     
-    return "";
-}
-
-// 结构体：库文件信息
-struct LibraryInfo {
-    std::string name;
-    size_t size;
-};
-
-// 执行命令并获取输出
-std::string executeCommand(const std::string& cmd) {
-    FILE* pipe = popen(cmd.c_str(), "r");
-    if (!pipe) {
-        LOGE("命令执行失败: %s", cmd.c_str());
-        return "";
+    bool append(CaptureKind kind, std::string_view name, const void* data, size_t size) {
+        return append(kind, name, {std::string_view(static_cast<const char*>(data), size)});
     }
     
-    std::stringstream result;
-    char buffer[256];
-    while (fgets(buffer, sizeof(buffer), pipe) != nullptr) {
-        result << buffer;
+private:
+    static constexpr size_t kBlockTarget = 256 * 1024;          // 未压缩数据攒到该大小即刷新
+    static constexpr size_t kMaxPayload = 16 * 1024 * 1024;
+    static constexpr size_t kMaxPendingBytes = 32 * 1024 * 1024;
+    static constexpr auto kFlushInterval = std::chrono::seconds(1);
+    
+    CaptureWriter() {
+        std::thread(&CaptureWriter::writerLoop, this).detach();
     }
     
-    pclose(pipe);
-    return result.str();
-}
-
-// 解析 ls -l 输出，找到最大的库
-std::vector<LibraryInfo> libraries;
-std::string findLargestLibrary(const std::string& lib_dir) {
-    Timer timer("findLargestLibrary");  // ⏱️ 计时开始
-    // 执行命令：ls -l | grep -v ^total
-    std::string cmd = "ls -l " + lib_dir + " | grep -v ^total";
-    std::string output = executeCommand(cmd);
-    
-    if (output.empty()) {
-        LOGE("库目录为空或命令执行失败: %s", lib_dir.c_str());
-        return "";
+    void countDropped() {
+        std::lock_guard<std::mutex> lock(mutex_);
+        dropped_++;
     }
     
-    // LOGI("ls -l 输出:\n%s", output.c_str());
+    void writerLoop() {
+        std::deque<std::vector<uint8_t>> batch;
+        uint64_t dropped_reported = 0;
+        
+        for (;;) {
+            uint64_t dropped;
+            {
+                // 有未刷新的记录时最多等到最早一条满 kFlushInterval
+                auto deadline = std::chrono::steady_clock::now() + kFlushInterval;
+                if (!block_.empty()) {
+                    deadline = std::min(deadline, block_started_ + kFlushInterval);
+                }
+                std::unique_lock<std::mutex> lock(mutex_);
+                cv_.wait_until(lock, deadline, [this] { return !pending_.empty(); });
+                batch.swap(pending_);
+                dropped = dropped_;
+            }
+            
+            if (dropped != dropped_reported) {
+                LOGE("⚠️ 捕获队列已满，累计丢弃 %llu 条记录", (unsigned long long)dropped);
+                dropped_reported = dropped;
+            }
+            
+            size_t released = 0;
+            for (std::vector<uint8_t>& record : batch) {
+                released += record.size();
+                if (block_.empty()) {
+                    block_started_ = std::chrono::steady_clock::now();
+                }
+                block_.insert(block_.end(), record.begin(), record.end());
+                block_records_++;
+                if (block_.size() >= kBlockTarget) {
+                    flushBlock();
+                }
+            }
+            batch.clear();
+            {
+                std::lock_guard<std::mutex> lock(mutex_);
+                pending_bytes_ -= released;
+            }
+            
+            // 最早一条记录入块已满一个刷新周期时，未满的块也写出（流量持续但很小时也不会长期滞留内存）
+            if (!block_.empty() && std::chrono::steady_clock::now() - block_started_ >= kFlushInterval) {
+                flushBlock();
+            }
+        }
+    }
+    
+    // 打开并独占锁定捕获文件，失败返回 -1
+    static int openLocked(const std::string& path) {
+        int fd = ::open(path.c_str(), O_RDWR | O_CREAT | O_CLOEXEC, 0644);
+        if (fd < 0) {
+            LOGE("❌ 无法打开捕获文件: %s (%s)", path.c_str(), strerror(errno));
+            return -1;
+        }
+        if (flock(fd, LOCK_EX | LOCK_NB) != 0) {
+            LOGI("捕获文件已被其他进程使用: %s (%s)", path.c_str(), strerror(errno));
+            close(fd);
+            return -1;
+        }
+        return fd;
+    }
     
+    // 打开（或续写）捕获文件：有效索引尾直接载入，否则按块头扫描恢复。
+    // 同一应用的多个进程共用包名目录：先抢占 capture.fgc，已被占用时改用 capture.<pid>.fgc
+    bool openFile() {
+        if (fd_ >= 0) return true;
+        if (write_failed_ || !g_readiness.isReady(READY_PACKAGE)) return false;
+        
+        std::string dir = "/sdcard/Android/data/" + g_pkg + "/cache/";
+        std::string path = dir + "capture.fgc";
+        fd_ = openLocked(path);
+        if (fd_ < 0) {
+            path = dir + "capture." + std::to_string(getpid()) + ".fgc";
+            fd_ = openLocked(path);
+        }
+        if (fd_ < 0) {
+            return false;
+        }
+        
+        struct stat st;
+        CaptureFileHeader file_header;
+        if (fstat(fd_, &st) != 0 || st.st_size < off_t(sizeof(file_header)) ||
+            pread(fd_, &file_header, sizeof(file_header), 0) != ssize_t(sizeof(file_header)) ||
+            file_header.magic != kCaptureFileMagic || file_header.version != kCaptureVersion) {
+            // 新文件（或无法识别的旧文件）：从头写
+            file_header = {kCaptureFileMagic, kCaptureVersion, 0};
+            if (ftruncate(fd_, 0) != 0) {
+                disableAfterWriteError("无法截断捕获文件");
+                return false;
+            }
+            if (pwrite(fd_, &file_header, sizeof(file_header), 0) != ssize_t(sizeof(file_header))) {
+                disableAfterWriteError("无法写入捕获文件头");
+                return false;
+            }
+            write_offset_ = sizeof(file_header);
+            LOGI("📦 新建捕获文件: %s", path.c_str());
+            return true;
+        }
+        
+        if (!loadIndex(st.st_size)) {
+            scanBlocks(st.st_size);
+        }
+        if (!index_.empty()) {
+            next_record_ = index_.back().first_record + index_.back().record_count;
+        }
+        LOGI("📦 续写捕获文件: %s (%zu 块, %llu 条记录)", path.c_str(), index_.size(),
+             (unsigned long long)next_record_);
+        return true;
+    }
     
-    std::istringstream stream(output);
-    std::string line;
+    bool loadIndex(off_t file_size) {
+        CaptureTrailer trailer;
+        if (file_size < off_t(sizeof(CaptureFileHeader) + sizeof(trailer)) ||
+            pread(fd_, &trailer, sizeof(trailer), file_size - sizeof(trailer)) != ssize_t(sizeof(trailer)) ||
+            trailer.magic != kCaptureTrailerMagic ||
+            trailer.index_offset + uint64_t(trailer.block_count) * sizeof(CaptureIndexEntry) + sizeof(trailer) !=
+                uint64_t(file_size)) {
+            return false;
+        }
+        index_.resize(trailer.block_count);
+        ssize_t bytes = index_.size() * sizeof(CaptureIndexEntry);
+        if (pread(fd_, index_.data(), bytes, trailer.index_offset) != bytes) {
+            index_.clear();
+            return false;
+        }
+        write_offset_ = trailer.index_offset;
+        return true;
+    }
     
-    // 正则表达式：匹配文件大小和 .so 文件名
-    // 格式：... size ... datetime filename.so
-    std::regex pattern(R"(\s+(\d+)\s+\d{4}-\d{2}-\d{2}\s+\d{2}:\d{2}\s+(\S+\.so))");
+    void scanBlocks(off_t file_size) {
+        index_.clear();
+        uint64_t offset = sizeof(CaptureFileHeader);
+        CaptureBlockHeader header;
+        while (offset + sizeof(header) <= uint64_t(file_size) &&
+               pread(fd_, &header, sizeof(header), offset) == ssize_t(sizeof(header)) &&
+               header.magic == kCaptureBlockMagic &&
+               offset + sizeof(header) + header.compressed_size <= uint64_t(file_size)) {
+            index_.push_back({offset, header.first_record, header.record_count, 0});
+            offset += sizeof(header) + header.compressed_size;
+        }
+        write_offset_ = offset;
+        LOGI("📦 捕获文件索引无效，扫描恢复 %zu 块", index_.size());
+    }
     
-    // 解析每一行
-    while (std::getline(stream, line)) {
-        // 跳过空行
-        if (line.empty() || line.find_first_not_of(" \t\r\n") == std::string::npos) {
-            continue;
+    void flushBlock() {
+        if (!openFile()) {
+            // 包名未知时保留在内存中，但不超过一个块太多；下一个刷新周期再试
+            if (!write_failed_ && block_.size() < kBlockTarget * 4) {
+                block_started_ = std::chrono::steady_clock::now();
+                return;
+            }
+            LOGE("⚠️ 捕获文件不可用，丢弃 %u 条记录", block_records_);
+            block_.clear();
+            block_records_ = 0;
+            return;
         }
         
-        std::smatch match;
-        if (std::regex_search(line, match, pattern)) {
-            // match[1] = 文件大小
-            // match[2] = 文件名
-            std::string size_str = match[1].str();
-            std::string filename = match[2].str();
-            
-            char* endptr = nullptr;
-            unsigned long long size = strtoull(size_str.c_str(), &endptr, 10);
-            
-            if (endptr != size_str.c_str() && *endptr == '\0') {
-                libraries.push_back({filename, static_cast<size_t>(size)});
-                LOGI("✓ 发现库: %s (大小: %zu 字节)", filename.c_str(), static_cast<size_t>(size));
-            } else {
-                LOGE("✗ 解析文件大小失败: size_str='%s'", size_str.c_str());
-            }
+        uLongf compressed_size = compressBound(block_.size());
+        compressed_.resize(sizeof(CaptureBlockHeader) + compressed_size);
+        int ret = compress2(compressed_.data() + sizeof(CaptureBlockHeader), &compressed_size,
+                            block_.data(), block_.size(), Z_BEST_SPEED);
+        if (ret != Z_OK) {
+            LOGE("❌ 压缩捕获块失败: %d", ret);
+            block_.clear();
+            block_records_ = 0;
+            return;
+        }
+        
+        CaptureBlockHeader header = {};
+        header.magic = kCaptureBlockMagic;
+        header.compressed_size = static_cast<uint32_t>(compressed_size);
+        header.uncompressed_size = static_cast<uint32_t>(block_.size());
+        header.record_count = block_records_;
+        header.first_record = next_record_;
+        header.crc32 = static_cast<uint32_t>(crc32(0, block_.data(), block_.size()));
+        memcpy(compressed_.data(), &header, sizeof(header));
+        
+        // 新块覆盖旧索引尾，随后写入新的索引与 Trailer
+        size_t block_bytes = sizeof(header) + compressed_size;
+        index_.push_back({write_offset_, next_record_, block_records_, 0});
+        CaptureTrailer trailer = {write_offset_ + block_bytes, uint32_t(index_.size()), kCaptureTrailerMagic};
+        compressed_.resize(block_bytes);
+        const uint8_t* index_bytes = reinterpret_cast<const uint8_t*>(index_.data());
+        compressed_.insert(compressed_.end(), index_bytes, index_bytes + index_.size() * sizeof(CaptureIndexEntry));
+        const uint8_t* trailer_bytes = reinterpret_cast<const uint8_t*>(&trailer);
+        compressed_.insert(compressed_.end(), trailer_bytes, trailer_bytes + sizeof(trailer));
+        
+        if (pwrite(fd_, compressed_.data(), compressed_.size(), write_offset_) != ssize_t(compressed_.size())) {
+            index_.pop_back();
+            disableAfterWriteError("写入捕获文件失败");
+        } else if (ftruncate(fd_, write_offset_ + compressed_.size()) != 0) {
+            // 扫描恢复后旧索引尾可能比新写入的内容长，截掉残余；截不掉时文件尾不可信
+            disableAfterWriteError("无法截断捕获文件");
         } else {
-            LOGI("⊘ 正则不匹配: %s", line.c_str());
+            write_offset_ += block_bytes;
+            next_record_ += block_records_;
         }
+        block_.clear();
+        block_records_ = 0;
     }
     
-    if (libraries.empty()) {
-        LOGE("未找到任何 .so 库文件");
-        return "";
+    // 写入出错（磁盘满、存储被卸载等）后关闭文件并关闭全部捕获，不再重试：
+    // 继续写只会留下 fgcap_read 无法识别的文件
+    void disableAfterWriteError(const char* what) {
+        LOGE("❌ %s: %s，停止捕获", what, strerror(errno));
+        close(fd_);
+        fd_ = -1;
+        write_failed_ = true;
+        mask_.store(0, std::memory_order_relaxed);
     }
     
-    // 找到最大的库
-    auto largest = std::max_element(libraries.begin(), libraries.end(),
-        [](const LibraryInfo& a, const LibraryInfo& b) {
-            return a.size < b.size;
-        });
+    std::atomic<uint32_t> mask_{(1u << CAPTURE_HTTP_REQUEST) | (1u << CAPTURE_HTTP_RESPONSE) | (1u << CAPTURE_LUA_CHUNK)};
+    
+    std::mutex mutex_;
+    std::condition_variable cv_;
+    std::deque<std::vector<uint8_t>> pending_;
+    size_t pending_bytes_ = 0;
+    uint64_t dropped_ = 0;
+    
+    // 以下只在后台线程使用
+    int fd_ = -1;
+    bool write_failed_ = false;
+    uint64_t write_offset_ = 0;
+    uint64_t next_record_ = 0;
+    std::vector<CaptureIndexEntry> index_;
+    std::vector<uint8_t> block_;
+    uint32_t block_records_ = 0;
+    std::chrono::steady_clock::time_point block_started_;     // 当前块第一条记录的入块时间
+    std::vector<uint8_t> compressed_;
+};
+
+// ============================
+// HTTP 响应捕获
+// ============================
+// 网络回调线程只读取响应字节：捕获开启（CaptureWriter 的 CAPTURE_HTTP_RESPONSE 位）时复制一次到
+// 预分配的缓冲池并入队，预览、"value1|value2|JSON" 拆分和写入捕获文件都在后台线程完成。
+// 捕获关闭或缓冲池耗尽（丢弃并计数）时只在回调线程原地打印预览。
+
+// 响应预览与 JSON 部分日志：按长度引用原始字节，不要求 '\0' 结尾，不复制
+static void logResponsePreview(const char* tag, std::string_view text) {
+    if (text.size() <= 500) {
+        LOGI("📥 [响应%s] 内容: %.*s", tag, (int)text.size(), text.data());
+    } else {
+        LOGI("📥 [响应%s] 内容(前500): %.500s...", tag, text.data());
+    }
     
-    LOGI("最大库: %s (大小: %zu 字节)", largest->name.c_str(), largest->size);
-    return largest->name;
+    // 解析响应格式：value1|value2|JSON（第二个 | 之后为 JSON）
+    size_t first_bar = text.find('|');
+    if (first_bar != std::string_view::npos) {
+        size_t second_bar = text.find('|', first_bar + 1);
+        if (second_bar != std::string_view::npos && second_bar + 1 < text.size()) {
+            std::string_view json_part = text.substr(second_bar + 1);
+            LOGI("📥 [响应%s] 💾 JSON部分(长度=%zu): %.*s%s", tag, json_part.size(),
+                 (int)std::min<size_t>(json_part.size(), 300), json_part.data(), json_part.size() > 300 ? "..." : "");
+        }
+    }
 }
 
-// 识别游戏引擎
-GameEngine identifyGameEngine(GumModule* module) {
-    Timer timer("identifyGameEngine");  // ⏱️ 计时开始
-    const gchar* module_name = gum_module_get_name(module);
-    std::string lower_name = module_name;
-    std::transform(lower_name.begin(), lower_name.end(), lower_name.begin(), ::tolower);
+class HttpCapture {
+public:
+    static constexpr size_t kMaxResponseSize = 100000;     // 超过的响应不捕获（与原实现一致）
     
-    if (lower_name.find("il2cpp") != std::string::npos || 
-        lower_name.find("unity") != std::string::npos) {
-        return GameEngine::UNITY;
+    static HttpCapture& instance() {
+        // 不析构：进程退出时后台线程可能仍在运行
+        static HttpCapture* capture = new HttpCapture();
+        return *capture;
     }
     
-    if (lower_name.find("ue4") != std::string::npos || 
-        lower_name.find("ue5") != std::string::npos ||
-        lower_name.find("unreal") != std::string::npos) {
-        return GameEngine::UNREAL;
-    }
+    bool enabled() const { return CaptureWriter::instance().enabled(CAPTURE_HTTP_RESPONSE); }
     
-    // ✅ 优化：通过文件名直接区分 Cocos2d-js 和 Cocos2d-x (C++)
-    // 避免两次耗时的符号枚举（从 500ms 降低到 < 1ms）
-    if (lower_name.find("cocos") != std::string::npos) {
-        // libcocos.so 和 libcocos2djs.so 归类为 Cocos2d-js
-        if (lower_name == "libcocos.so" || lower_name == "libcocos2djs.so") {
-            LOGI("根据文件名识别为 Cocos2d-js: %s", module_name);
-            return GameEngine::COCOS2D_JS;
+    // 在网络回调线程调用，返回是否已入队
+    bool submit(int response_code, const char* data, size_t size) {
+        if (size > kMaxResponseSize) {
+            return false;
+        }
+        Buffer* buffer = nullptr;
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            if (free_.empty()) {
+                dropped_++;
+                return false;
+            }
+            buffer = free_.back();
+            free_.pop_back();
         }
         
-        // 其他 cocos 相关库归类为 Cocos2d-x (C++)
-        LOGI("根据文件名识别为 Cocos2d-x (C++): %s", module_name);
-        return GameEngine::COCOS2D_CPP;
+        memcpy(buffer->data.get(), data, size);
+        buffer->data[size] = '\0';
+        buffer->size = size;
+        buffer->response_code = response_code;
+        
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            buffer->sequence = ++sequence_;
+            pending_.push_back(buffer);
+        }
+        cv_.notify_one();
+        return true;
     }
     
-    if (lower_name.find("godot") != std::string::npos) {
-        return GameEngine::GODOT;
+private:
+    static constexpr size_t kBufferCount = 8;
+    
+    struct Buffer {
+        std::unique_ptr<char[]> data;
+        size_t size = 0;
+        int response_code = 0;
+        uint64_t sequence = 0;
+    };
+    
+    HttpCapture() {
+        buffers_.resize(kBufferCount);
+        for (Buffer& buffer : buffers_) {
+            buffer.data.reset(new char[kMaxResponseSize + 1]);
+            free_.push_back(&buffer);
+        }
+        std::thread(&HttpCapture::workerLoop, this).detach();
     }
     
-    return GameEngine::UNKNOWN;
-}
-
-// 获取引擎名称
-const char* getEngineName(GameEngine engine) {
-    switch (engine) {
-        case GameEngine::UNITY: return "Unity";
-        case GameEngine::UNREAL: return "Unreal Engine";
-        case GameEngine::COCOS2D_CPP: return "Cocos2d-x (C++)";
-        case GameEngine::COCOS2D_JS: return "Cocos2d-js (JavaScript)";
-        case GameEngine::GODOT: return "Godot";
-        default: return "Unknown";
+    void workerLoop() {
+        uint64_t dropped_reported = 0;
+        for (;;) {
+            Buffer* buffer;
+            uint64_t dropped;
+            {
+                std::unique_lock<std::mutex> lock(mutex_);
+                cv_.wait(lock, [this] { return !pending_.empty(); });
+                buffer = pending_.front();
+                pending_.pop_front();
+                dropped = dropped_;
+            }
+            
+            if (dropped != dropped_reported) {
+                LOGE("⚠️ HTTP 捕获缓冲池已满，累计丢弃 %llu 个响应", (unsigned long long)dropped);
+                dropped_reported = dropped;
+            }
+            
+            process(*buffer);
+            
+            std::lock_guard<std::mutex> lock(mutex_);
+            free_.push_back(buffer);
+        }
     }
-}
-
-// 全局加速倍率
-static float g_speed_multiplier = 4.0f;
-
-// Cocos2d-js 相关全局变量
-static int mycount = 100;                  // JS 调用计数器
-static std::string g_pkg;                // 全局包名
-
-// JSON 对象指针 → 原始字符串 映射表
-static std::unordered_map<void*, std::string> g_json_string_map;
-
-// 最近的 JSON 字符串缓存（简单方案）
-static std::string g_last_json_string;
+    
+    void process(const Buffer& buffer) {
+        char tag[32];
+        snprintf(tag, sizeof(tag), " #%llu", (unsigned long long)buffer.sequence);
+        logResponsePreview(tag, std::string_view(buffer.data.get(), buffer.size));
+        persist(buffer);
+    }
+    
+    void persist(const Buffer& buffer) {
+        char name[32];
+        snprintf(name, sizeof(name), "code=%d", buffer.response_code);
+        CaptureWriter::instance().append(CAPTURE_HTTP_RESPONSE, name, buffer.data.get(), buffer.size);
+    }
+    
+    std::vector<Buffer> buffers_;
+    
+    std::mutex mutex_;
+    std::condition_variable cv_;
+    std::vector<Buffer*> free_;
+    std::deque<Buffer*> pending_;
+    uint64_t sequence_ = 0;
+    uint64_t dropped_ = 0;
+};
 
 // libcocos2dcpp.so 基址（用于访问全局变量）
 static GumAddress g_cocos2d_base_addr = 0;
@@ -598,124 +3401,302 @@ bool loadRequestFromFile(int request_id, CachedRequest& req) {
     return true;
 }
 
-// 符号缓存文件路径
-std::string getSymbolCachePath() {
-    return std::string("/sdcard/Android/data/") + g_pkg + "/cache/symbols.cache";
+// ============================
+// 符号偏移缓存（二进制，按模块 build-id 区分）
+// ============================
+
+// 64 位 FNV-1a
+static uint64_t hashBytes(const void* data, size_t size, uint64_t seed = 0xcbf29ce484222325ULL) {
+    const uint8_t* bytes = static_cast<const uint8_t*>(data);
+    uint64_t hash = seed;
+    for (size_t i = 0; i < size; ++i) {
+        hash ^= bytes[i];
+        hash *= 0x100000001b3ULL;
+    }
+    return hash;
 }
 
-// 缓存条目类型
-enum class CacheType {
-    NONE,       // 未找到
-    SYMBOL,     // 符号名
-    OFFSET      // 内存搜索偏移
-};
+// 从已加载模块的 PT_NOTE 段读取 GNU build-id，未找到返回空
+static std::string_view readGnuBuildId(GumModule* module) {
+    const GumMemoryRange* range = gum_module_get_range(module);
+    auto base = static_cast<uintptr_t>(range->base_address);
+    const auto* ehdr = reinterpret_cast<const Elf64_Ehdr*>(base);
+    if (memcmp(ehdr->e_ident, ELFMAG, SELFMAG) != 0 || ehdr->e_ident[EI_CLASS] != ELFCLASS64) {
+        return {};
+    }
 
-// 缓存条目结构
-struct CacheEntry {
-    CacheType type;
-    std::string value;  // 符号名 或 偏移量(十六进制字符串)
-};
+    const auto* phdrs = reinterpret_cast<const Elf64_Phdr*>(base + ehdr->e_phoff);
 
-// 从文件读取缓存条目（带类型）
-CacheEntry readFromCache(const std::string& cache_key) {
-    std::string cache_path = getSymbolCachePath();
-    std::ifstream cache_file(cache_path);
-    
-    if (!cache_file.is_open()) {
-        LOGD("符号缓存文件不存在: %s", cache_path.c_str());
-        return {CacheType::NONE, ""};
+    // 加载偏移 = 实际基址 - 首个 PT_LOAD 的虚拟地址
+    uintptr_t load_bias = base;
+    for (int i = 0; i < ehdr->e_phnum; ++i) {
+        if (phdrs[i].p_type == PT_LOAD) {
+            load_bias = base - (phdrs[i].p_vaddr & ~static_cast<uint64_t>(getpagesize() - 1));
+            break;
+        }
     }
-    
-    std::string line;
-    while (std::getline(cache_file, line)) {
-        // 格式：cache_key=type:value
-        // 示例：ScriptEngine_evalString=symbol:_ZN2se12ScriptEngine10evalStringE...
-        //      或 ScriptEngine_evalString=offset:0xbc8
-        size_t pos = line.find('=');
-        if (pos != std::string::npos) {
-            std::string key = line.substr(0, pos);
-            std::string data = line.substr(pos + 1);
-            
-            if (key == cache_key) {
-                // 解析类型和值
-                size_t colon_pos = data.find(':');
-                if (colon_pos != std::string::npos) {
-                    std::string type_str = data.substr(0, colon_pos);
-                    std::string value = data.substr(colon_pos + 1);
-                    
-                    CacheType type = CacheType::NONE;
-                    if (type_str == "symbol") {
-                        type = CacheType::SYMBOL;
-                    } else if (type_str == "offset") {
-                        type = CacheType::OFFSET;
-                    }
-                    
-                    cache_file.close();
-                    LOGI("✓ 从缓存读取: %s = %s:%s", cache_key.c_str(), type_str.c_str(), value.c_str());
-                    return {type, value};
-                }
+
+    for (int i = 0; i < ehdr->e_phnum; ++i) {
+        if (phdrs[i].p_type != PT_NOTE) continue;
+
+        uintptr_t note = load_bias + phdrs[i].p_vaddr;
+        uintptr_t note_end = note + phdrs[i].p_memsz;
+        while (note + sizeof(Elf64_Nhdr) <= note_end) {
+            const auto* nhdr = reinterpret_cast<const Elf64_Nhdr*>(note);
+            uintptr_t name = note + sizeof(Elf64_Nhdr);
+            uintptr_t desc = name + ((nhdr->n_namesz + 3) & ~3u);
+            if (nhdr->n_type == NT_GNU_BUILD_ID && nhdr->n_namesz == 4 &&
+                memcmp(reinterpret_cast<const void*>(name), "GNU", 4) == 0) {
+                return std::string_view(reinterpret_cast<const char*>(desc), nhdr->n_descsz);
             }
+            note = desc + ((nhdr->n_descsz + 3) & ~3u);
         }
     }
-    
-    cache_file.close();
-    LOGD("缓存中未找到: %s", cache_key.c_str());
-    return {CacheType::NONE, ""};
+    return {};
 }
 
-// 保存到缓存（带类型）
-void saveToCache(const std::string& cache_key, CacheType type, const std::string& value) {
-    std::string cache_path = getSymbolCachePath();
-    
-    // 读取现有缓存
-    std::unordered_map<std::string, std::string> symbols;
-    std::ifstream cache_file_read(cache_path);
-    if (cache_file_read.is_open()) {
-        std::string line;
-        while (std::getline(cache_file_read, line)) {
-            size_t pos = line.find('=');
-            if (pos != std::string::npos) {
-                std::string key = line.substr(0, pos);
-                std::string data = line.substr(pos + 1);
-                symbols[key] = data;
+// 模块身份：优先 GNU build-id，否则使用 路径 + 文件大小 + mtime 的哈希
+static uint64_t computeModuleKey(GumModule* module) {
+    std::string_view build_id = readGnuBuildId(module);
+    if (!build_id.empty()) {
+        return hashBytes(build_id.data(), build_id.size());
+    }
+
+    const char* path = gum_module_get_path(module);
+    uint64_t key = hashBytes(path, strlen(path));
+    struct stat st;
+    if (stat(path, &st) == 0) {
+        uint64_t identity[3] = {
+            static_cast<uint64_t>(st.st_size),
+            static_cast<uint64_t>(st.st_mtim.tv_sec),
+            static_cast<uint64_t>(st.st_mtim.tv_nsec),
+        };
+        key = hashBytes(identity, sizeof(identity), key);
+    }
+    return key;
+}
+
+// 缓存文件格式（小端，版本变化时整体失效）：
+//   Header { magic "FGSC", version, bucket_count(2 的幂), entry_count }
+//   Bucket[bucket_count] { module_key, name_hash, offset }，开放寻址线性探测，module_key=0 为空槽
+// 启动时只读 mmap，查找为一次哈希 + 少量探测，无需解析
+class SymbolCache {
+public:
+    static SymbolCache& instance() {
+        static SymbolCache cache;
+        return cache;
+    }
+
+    // 查找模块内某个 Hook 目标的偏移（相对模块基址），并换算为绝对地址；未命中返回 0
+    GumAddress lookup(GumModule* module, std::string_view key) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        ensureMappedLocked();
+
+        uint64_t module_key = moduleKeyLocked(module);
+        uint64_t name_hash = hashBytes(key.data(), key.size());
+        const GumMemoryRange* range = gum_module_get_range(module);
+
+        uint64_t offset = 0;
+        auto pending = pending_.find({module_key, name_hash});
+        if (pending != pending_.end()) {
+            offset = pending->second;
+        } else if (const Bucket* bucket = findBucketLocked(module_key, name_hash)) {
+            offset = bucket->offset;
+        } else {
+            LOGD("缓存中未找到: %.*s", (int)key.size(), key.data());
+            return 0;
+        }
+
+        if (offset >= range->size) {
+            LOGE("缓存偏移越界，忽略: %.*s = 0x%lx", (int)key.size(), key.data(), (unsigned long)offset);
+            return 0;
+        }
+        LOGI("✓ 从缓存读取: %.*s = +0x%lx", (int)key.size(), key.data(), (unsigned long)offset);
+        return range->base_address + offset;
+    }
+
+    // 保存 Hook 目标的绝对地址（以相对模块基址的偏移存储），并立即写回文件
+    void store(GumModule* module, std::string_view key, GumAddress address) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        ensureMappedLocked();
+
+        const GumMemoryRange* range = gum_module_get_range(module);
+        uint64_t offset = address - range->base_address;
+        pending_[{moduleKeyLocked(module), hashBytes(key.data(), key.size())}] = offset;
+
+        if (flushLocked()) {
+            LOGI("✓ 保存到缓存: %.*s = +0x%lx", (int)key.size(), key.data(), (unsigned long)offset);
+        }
+    }
+
+private:
+    static constexpr uint32_t kMagic = 0x43534746;  // "FGSC"
+    static constexpr uint32_t kVersion = 1;
+
+    struct Header {
+        uint32_t magic;
+        uint32_t version;
+        uint32_t bucket_count;
+        uint32_t entry_count;
+    };
+
+    struct Bucket {
+        uint64_t module_key;
+        uint64_t name_hash;
+        uint64_t offset;
+    };
+
+    struct KeyHash {
+        size_t operator()(const std::pair<uint64_t, uint64_t>& k) const {
+            return static_cast<size_t>(k.first ^ (k.second * 0x9e3779b97f4a7c15ULL));
+        }
+    };
+
+    SymbolCache() = default;
+
+    static std::string cachePath() {
+        return std::string("/sdcard/Android/data/") + g_pkg + "/cache/symbols.bin";
+    }
+
+    uint64_t moduleKeyLocked(GumModule* module) {
+        std::string path = gum_module_get_path(module);
+        auto it = module_keys_.find(path);
+        if (it != module_keys_.end()) return it->second;
+        uint64_t key = computeModuleKey(module);
+        if (key == 0) key = 1;  // 0 保留为空槽
+        module_keys_.emplace(std::move(path), key);
+        return key;
+    }
+
+    // 包名就绪之前路径无效：不记为已尝试，就绪后的下一次调用再映射
+    void ensureMappedLocked() {
+        if (map_attempted_) return;
+        if (!g_readiness.isReady(READY_PACKAGE)) return;
+        map_attempted_ = true;
+        unmapLocked();
+
+        std::string path = cachePath();
+        int fd = open(path.c_str(), O_RDONLY | O_CLOEXEC);
+        if (fd < 0) {
+            LOGD("符号缓存文件不存在: %s", path.c_str());
+            return;
+        }
+
+        struct stat st;
+        if (fstat(fd, &st) == 0 && st.st_size >= (off_t)sizeof(Header)) {
+            void* addr = mmap(nullptr, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+            if (addr != MAP_FAILED) {
+                const auto* header = static_cast<const Header*>(addr);
+                uint32_t buckets = header->bucket_count;
+                bool valid = header->magic == kMagic && header->version == kVersion &&
+                             buckets != 0 && (buckets & (buckets - 1)) == 0 &&
+                             sizeof(Header) + (size_t)buckets * sizeof(Bucket) <= (size_t)st.st_size;
+                if (valid) {
+                    map_base_ = addr;
+                    map_size_ = st.st_size;
+                    LOGI("符号缓存已映射: %s (%u 条)", path.c_str(), header->entry_count);
+                } else {
+                    LOGE("符号缓存格式或版本不匹配，忽略: %s", path.c_str());
+                    munmap(addr, st.st_size);
+                }
             }
         }
-        cache_file_read.close();
+        close(fd);
     }
-    
-    // 构造数据（type:value）
-    std::string type_str = (type == CacheType::SYMBOL) ? "symbol" : "offset";
-    std::string data = type_str + ":" + value;
-    symbols[cache_key] = data;
-    
-    // 写回文件
-    std::ofstream cache_file_write(cache_path);
-    if (!cache_file_write.is_open()) {
-        LOGE("无法写入符号缓存文件: %s", cache_path.c_str());
-        return;
+
+    void unmapLocked() {
+        if (map_base_) {
+            munmap(map_base_, map_size_);
+            map_base_ = nullptr;
+            map_size_ = 0;
+        }
     }
-    
-    for (const auto& [key, val] : symbols) {
-        cache_file_write << key << "=" << val << std::endl;
+
+    const Header* headerLocked() const { return static_cast<const Header*>(map_base_); }
+
+    const Bucket* bucketsLocked() const {
+        return reinterpret_cast<const Bucket*>(static_cast<const char*>(map_base_) + sizeof(Header));
     }
-    
-    cache_file_write.close();
-    LOGI("✓ 保存到缓存: %s = %s:%s", cache_key.c_str(), type_str.c_str(), value.c_str());
-}
 
-// 兼容旧接口（仅用于符号名）
-std::string readSymbolNameFromCache(const std::string& cache_key) {
-    CacheEntry entry = readFromCache(cache_key);
-    if (entry.type == CacheType::SYMBOL) {
-        return entry.value;
+    const Bucket* findBucketLocked(uint64_t module_key, uint64_t name_hash) const {
+        if (!map_base_) return nullptr;
+        uint32_t mask = headerLocked()->bucket_count - 1;
+        const Bucket* buckets = bucketsLocked();
+        for (uint32_t i = 0, slot = bucketSlot(module_key, name_hash) & mask; i <= mask; ++i, slot = (slot + 1) & mask) {
+            const Bucket& bucket = buckets[slot];
+            if (bucket.module_key == 0) return nullptr;
+            if (bucket.module_key == module_key && bucket.name_hash == name_hash) return &bucket;
+        }
+        return nullptr;
     }
-    return "";
-}
 
-// 兼容旧接口（仅用于符号名）
-void saveSymbolNameToCache(const std::string& cache_key, const std::string& symbol_name) {
-    saveToCache(cache_key, CacheType::SYMBOL, symbol_name);
-}
+    static uint32_t bucketSlot(uint64_t module_key, uint64_t name_hash) {
+        uint64_t h = (module_key ^ name_hash) * 0x9e3779b97f4a7c15ULL;
+        return static_cast<uint32_t>(h >> 32);
+    }
+
+    // 合并已映射条目与新条目，写入临时文件后原子替换，再重新映射
+    bool flushLocked() {
+        // 包名未就绪时条目留在 pending_，就绪后下一次 store 一并写回
+        if (!g_readiness.isReady(READY_PACKAGE)) {
+            LOGD("包名未就绪，符号缓存暂存内存 (%zu 条)", pending_.size());
+            return false;
+        }
+        ensureMappedLocked();  // 先载入已有文件再合并，避免覆盖掉其中的条目
+        std::unordered_map<std::pair<uint64_t, uint64_t>, uint64_t, KeyHash> merged;
+        if (map_base_) {
+            const Bucket* buckets = bucketsLocked();
+            for (uint32_t i = 0; i < headerLocked()->bucket_count; ++i) {
+                if (buckets[i].module_key != 0) {
+                    merged[{buckets[i].module_key, buckets[i].name_hash}] = buckets[i].offset;
+                }
+            }
+        }
+        for (const auto& [key, offset] : pending_) {
+            merged[key] = offset;
+        }
+
+        // 负载因子 <= 0.5
+        uint32_t bucket_count = 16;
+        while (bucket_count < merged.size() * 2) bucket_count <<= 1;
+
+        std::vector<Bucket> table(bucket_count, Bucket{0, 0, 0});
+        for (const auto& [key, offset] : merged) {
+            uint32_t slot = bucketSlot(key.first, key.second) & (bucket_count - 1);
+            while (table[slot].module_key != 0) slot = (slot + 1) & (bucket_count - 1);
+            table[slot] = {key.first, key.second, offset};
+        }
+
+        Header header = {kMagic, kVersion, bucket_count, static_cast<uint32_t>(merged.size())};
+        std::string path = cachePath();
+        std::string tmp_path = path + ".tmp";
+        int fd = open(tmp_path.c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+        if (fd < 0) {
+            LOGE("无法写入符号缓存文件: %s", tmp_path.c_str());
+            return false;
+        }
+        bool ok = write(fd, &header, sizeof(header)) == (ssize_t)sizeof(header) &&
+                  write(fd, table.data(), table.size() * sizeof(Bucket)) == (ssize_t)(table.size() * sizeof(Bucket));
+        close(fd);
+        if (!ok || rename(tmp_path.c_str(), path.c_str()) != 0) {
+            LOGE("符号缓存写入失败: %s", path.c_str());
+            unlink(tmp_path.c_str());
+            return false;
+        }
+
+        pending_.clear();
+        map_attempted_ = false;
+        ensureMappedLocked();
+        return true;
+    }
+
+    std::mutex mutex_;
+    bool map_attempted_ = false;
+    void* map_base_ = nullptr;
+    size_t map_size_ = 0;
+    std::unordered_map<std::string, uint64_t> module_keys_;
+    std::unordered_map<std::pair<uint64_t, uint64_t>, uint64_t, KeyHash> pending_;
+};
 
 // ============================
 // 网络 Hook 相关
@@ -777,27 +3758,30 @@ static InitFXFunc original_initFX = nullptr;
 
 // Hook 后的 checkMenu：进入时强制邀请进度满足并清空领取位图
 static int64_t* hooked_checkMenu(int64_t* ui_fx_this) {
+    HookProbe probe(HookMetricId::CHECK_MENU);
     // 每次菜单检查前强制刷新邀请进度与领取位图
     forceInviteProgressMax();
 
     if (original_checkMenu) {
-        return original_checkMenu(ui_fx_this);
+        return probe.callOriginal(original_checkMenu, ui_fx_this);
     }
     return ui_fx_this;
 }
 
 // Hook 后的 initFX：初始化界面时同步伪造邀请进度为 999
 static void* hooked_initFX(void* ui_fx_this) {
+    HookProbe probe(HookMetricId::INIT_FX);
     // 写入固定显示/判定值 999，并清空领取位图
     forceInviteProgressValue(999);
     if (original_initFX) {
-        return original_initFX(ui_fx_this);
+        return probe.callOriginal(original_initFX, ui_fx_this);
     }
     return ui_fx_this;
 }
 
 // Hook 后的 updateMoney 函数
 static int64_t hooked_updateMoney(void* this_ptr, int add_value, bool save_to_db) {
+    HookProbe probe(HookMetricId::UPDATE_MONEY);
     // 🔍 检查是否已经修改过
     static bool checked_state = false;
     static bool already_modified = false;
@@ -816,7 +3800,7 @@ static int64_t hooked_updateMoney(void* this_ptr, int add_value, bool save_to_db
     
     // 如果已经修改过，直接调用原始函数
     if (already_modified) {
-        return original_updateMoney(this_ptr, add_value, save_to_db);
+        return probe.callOriginal(original_updateMoney, this_ptr, add_value, save_to_db);
     }
     
     LOGI("━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━");
@@ -866,11 +3850,12 @@ static int64_t hooked_updateMoney(void* this_ptr, int add_value, bool save_to_db
     LOGI("━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━");
     
     // 调用原始函数（但值已被我们修改）
-    return original_updateMoney(this_ptr, add_value, save_to_db);
+    return probe.callOriginal(original_updateMoney, this_ptr, add_value, save_to_db);
 }
 
 // Hook 后的 updateGold 函数
 static int64_t hooked_updateGold(void* this_ptr, int add_value, bool save_to_db) {
+    HookProbe probe(HookMetricId::UPDATE_GOLD);
     // 🔍 检查是否已经修改过
     static bool checked_state = false;
     static bool already_modified = false;
@@ -889,7 +3874,7 @@ static int64_t hooked_updateGold(void* this_ptr, int add_value, bool save_to_db)
     
     // 如果已经修改过，直接调用原始函数
     if (already_modified) {
-        return original_updateGold(this_ptr, add_value, save_to_db);
+        return probe.callOriginal(original_updateGold, this_ptr, add_value, save_to_db);
     }
     
     LOGI("━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━");
@@ -939,7 +3924,7 @@ static int64_t hooked_updateGold(void* this_ptr, int add_value, bool save_to_db)
     LOGI("━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━");
     
     // 调用原始函数（但值已被我们修改）
-    return original_updateGold(this_ptr, add_value, save_to_db);
+    return probe.callOriginal(original_updateGold, this_ptr, add_value, save_to_db);
 }
 
 // Hook 后的 sendData 函数
@@ -947,6 +3932,7 @@ static void* hooked_sendData(
     void* curl_http,
     int a2, int a3, int a4, int a5, int a6, int a7, int a8,
     char* a9, char* a10, char* a11, bool a12) {
+    HookProbe probe(HookMetricId::SEND_DATA);
     
     LOGI("━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━");
     LOGI("📤 [网络请求] CurlHttp::sendData");
@@ -1133,8 +4119,18 @@ static void* hooked_sendData(
     
     LOGI("━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━");
     
+    // 记录实际发送的参数
+    if (CaptureWriter::instance().enabled(CAPTURE_HTTP_REQUEST)) {
+        char capture_name[48];
+        snprintf(capture_name, sizeof(capture_name), "id=%d op=%d", a2, a3);
+        CaptureWriter::instance().append(CAPTURE_HTTP_REQUEST, capture_name, {
+            final_a9 ? std::string_view(final_a9) : std::string_view(),
+            final_a10 ? std::string_view(final_a10) : std::string_view(),
+            final_a11 ? std::string_view(final_a11) : std::string_view()});
+    }
+    
     // 调用原始函数（使用处理后的参数）
-    return original_sendData(curl_http, a2, a3, a4, a5, a6, a7, a8, 
+    return probe.callOriginal(original_sendData, curl_http, a2, a3, a4, a5, a6, a7, a8, 
                             final_a9, final_a10, final_a11, a12);
 }
 
@@ -1143,6 +4139,7 @@ static void* hooked_onHttpCompleted(
     void* curl_http,
     void* http_client,
     void* http_response) {
+    HookProbe probe(HookMetricId::ON_HTTP_COMPLETED);
     
     LOGI("━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━");
     LOGI("📥 [网络响应] CurlHttp::onHttpRequestCompleted");
@@ -1150,9 +4147,6 @@ static void* hooked_onHttpCompleted(
     LOGI("  HttpClient: %p", http_client);
     LOGI("  HttpResponse: %p", http_response);
     
-    // 存储响应字符串，供后续 parseJson 使用
-    std::string response_text;
-    
     // 尝试读取响应码（偏移 +0x28 处，HttpResponse::_responseCode）
     if (http_response) {
         int* response_code_ptr = (int*)((char*)http_response + 0x20);
@@ -1166,38 +4160,16 @@ static void* hooked_onHttpCompleted(
             size_t capacity;
         };
         
+        // 原地引用响应数据（不以 '\0' 结尾，不能直接按 %s 打印）；捕获开启时预览与拆分交给后台捕获线程
         ResponseDataVector* response_data = (ResponseDataVector*)((char*)http_response + 0x30);
-        if (response_data && response_data->size > 0 && response_data->size < 100000) {
+        if (response_data && response_data->size > 0 && response_data->size < HttpCapture::kMaxResponseSize) {
             LOGI("  响应数据大小: %zu 字节", response_data->size);
             
-            // 保存完整响应文本
-            if (response_data->data && response_data->size > 0) {
-                response_text.assign(response_data->data, response_data->size);
-                
-                // 打印响应预览
-                if (response_data->size <= 500) {
-                    LOGI("  响应内容: %s", response_text.c_str());
-                } else {
-                    LOGI("  响应内容(前500): %.500s...", response_text.c_str());
-                }
-                
-                // 解析响应格式：value1|value2|JSON
-                // 使用 "|" 分隔符分割
-                size_t first_bar = response_text.find('|');
-                if (first_bar != std::string::npos) {
-                    size_t second_bar = response_text.find('|', first_bar + 1);
-                    if (second_bar != std::string::npos && second_bar + 1 < response_text.length()) {
-                        // 提取 JSON 部分（第二个 | 之后）
-                        std::string json_part = response_text.substr(second_bar + 1);
-                        
-                        // 保存到全局变量（简单方案）
-                        g_last_json_string = json_part;
-                        
-                        LOGI("  💾 JSON部分(长度=%zu): %.300s%s", 
-                             json_part.length(), 
-                             json_part.c_str(),
-                             json_part.length() > 300 ? "..." : "");
-                    }
+            if (response_data->data) {
+                HttpCapture& capture = HttpCapture::instance();
+                if (!capture.enabled() ||
+                    !capture.submit(*response_code_ptr, response_data->data, response_data->size)) {
+                    logResponsePreview("", std::string_view(response_data->data, response_data->size));
                 }
             }
         }
@@ -1206,20 +4178,21 @@ static void* hooked_onHttpCompleted(
     LOGI("━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━");
     
     // 调用原始函数
-    return original_onHttpCompleted(curl_http, http_client, http_response);
+    return probe.callOriginal(original_onHttpCompleted, curl_http, http_client, http_response);
 }
 
 // Hook 后的 Json_create 函数
 static void* hooked_json_create(const char* json_string) {
+    HookProbe probe(HookMetricId::JSON_CREATE);
     // 调用原始函数创建 JSON 对象
-    void* json_object = original_json_create(json_string);
+    void* json_object = probe.callOriginal(original_json_create, json_string);
     
     // 保存 JSON 对象指针和字符串的映射关系
     if (json_object && json_string) {
-        size_t len = strnlen(json_string, 50000);  // 最多检查50KB
-        if (len > 0 && len < 50000) {
-            g_json_string_map[json_object] = std::string(json_string, len);
-            LOGD("💾 [JSON创建] 对象=%p, 长度=%zu", json_object, len);
+        size_t len = strnlen(json_string, JsonStringTable::kMaxLength);
+        if (len > 0 && len < JsonStringTable::kMaxLength) {
+            bool stored = g_json_strings.insert(json_object, json_string, len);
+            LOGD("💾 [JSON创建] 对象=%p, 长度=%zu%s", json_object, len, stored ? "" : " (内存已达上限，未保存内容)");
         }
     }
     
@@ -1228,19 +4201,19 @@ static void* hooked_json_create(const char* json_string) {
 
 // Hook 后的 Json_dispose 函数
 static void hooked_json_dispose(void* json_object) {
+    HookProbe probe(HookMetricId::JSON_DISPOSE);
     // 从映射表中删除
-    auto it = g_json_string_map.find(json_object);
-    if (it != g_json_string_map.end()) {
+    if (g_json_strings.erase(json_object)) {
         LOGD("🗑️ [JSON释放] 对象=%p", json_object);
-        g_json_string_map.erase(it);
     }
     
     // 调用原始函数
-    original_json_dispose(json_object);
+    probe.callOriginal(original_json_dispose, json_object);
 }
 
 // Hook 后的 parseJson 函数
 static void* hooked_parseJson(void* curl_http, int a2, void* json) {
+    HookProbe probe(HookMetricId::PARSE_JSON);
     LOGI("━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━");
     LOGI("🔍 [JSON解析] CurlHttp::parseJson");
     LOGI("  this: %p", curl_http);
@@ -1248,32 +4221,31 @@ static void* hooked_parseJson(void* curl_http, int a2, void* json) {
     LOGI("  JSON对象: %p", json);
     
     // 从映射表中查找 JSON 字符串（使用 JSON 对象指针作为 key）
-    auto it = g_json_string_map.find(json);
-    if (it != g_json_string_map.end()) {
-        const std::string& json_str = it->second;
-        size_t len = json_str.length();
-        
+    bool found = g_json_strings.visit(json, [](const char* json_str, size_t len) {
         LOGI("  📄 JSON长度: %zu 字节", len);
         
-        if (len <= 800) {
+        if (!json_str) {
+            LOGI("  📄 JSON内容未保存（内存已达上限）");
+        } else if (len <= 800) {
             // 短 JSON，直接打印
-            LOGI("  📄 JSON内容: %s", json_str.c_str());
+            LOGI("  📄 JSON内容: %s", json_str);
         } else {
             // 长 JSON，打印前800字符和后200字符
-            LOGI("  📄 JSON开头(800字符): %.800s...", json_str.c_str());
+            LOGI("  📄 JSON开头(800字符): %.800s...", json_str);
             if (len > 200) {
-                const char* end_start = json_str.c_str() + (len - 200);
+                const char* end_start = json_str + (len - 200);
                 LOGI("  📄 JSON结尾(200字符): ...%s", end_start);
             }
         }
-    } else {
+    });
+    if (!found) {
         LOGD("  ℹ️ 未找到 JSON 对象的字符串映射");
     }
     
     LOGI("━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━");
     
     // 调用原始函数
-    return original_parseJson(curl_http, a2, json);
+    return probe.callOriginal(original_parseJson, curl_http, a2, json);
 }
 
 // ============================
@@ -1286,534 +4258,433 @@ static UpdateFunc original_update = nullptr;
 
 // Hook 后的 update 函数
 static void hooked_update(void* scheduler, float dt) {
+    HookProbe probe(HookMetricId::SCHEDULER_UPDATE);
     // 修改 delta time，实现加速
     float modified_dt = dt * g_speed_multiplier;
     // LOGI("Cocos2d-x update: dt=%.4f -> %.4f (%.1fx速)", dt, modified_dt, g_speed_multiplier);
-    original_update(scheduler, modified_dt);
+    probe.callOriginal(original_update, scheduler, modified_dt);
 }
 
-// Hook 网络函数
-void hookNetworkFunctions(GumModule* module) {
-    LOGI("🌐 开始 Hook 网络函数...");
-    GumInterceptor* interceptor = gum_interceptor_obtain();
-
-    // Hook 1: CurlHttp::sendData (0x3b51dc)
-    // 使用基址 + 偏移的方式
-    const GumMemoryRange* range = gum_module_get_range(module);
-    GumAddress base_addr = range->base_address;
-    
-    // 保存基址到全局变量（供 updateMoney/updateGold 使用）
-    g_cocos2d_base_addr = base_addr;
-    LOGI("📍 libcocos2dcpp.so 基址: 0x%lx", base_addr);
-
-    // // Hook 3: UI_FX::checkMenu (起始 0x4aa998) — 硬编码邀请进度判定
-    // GumAddress checkMenu_addr = base_addr + 0x4aa998;
-    // LOGI("尝试 Hook UI_FX::checkMenu @ 0x%lx", checkMenu_addr);
-    // gum_interceptor_begin_transaction(interceptor);
-    // GumReplaceReturn ret_check = gum_interceptor_replace_fast(
-    //     interceptor,
-    //     GSIZE_TO_POINTER(checkMenu_addr),
-    //     (gpointer)hooked_checkMenu,
-    //     (gpointer*)&original_checkMenu
-    // );
-    // gum_interceptor_end_transaction(interceptor);
-    // if (ret_check == GUM_REPLACE_OK) {
-    //     LOGI("✅ Hook UI_FX::checkMenu 成功");
-    // } else {
-    //     LOGE("❌ Hook UI_FX::checkMenu 失败: 错误码 %d", ret_check);
-    // }
-
-    // Hook 4: UI_FX::initFX (起始 0x4aac04) — 初始化时将邀请进度写为 999
-    GumAddress initFX_addr = base_addr + 0x4aac04;
-    LOGI("尝试 Hook UI_FX::initFX @ 0x%lx", initFX_addr);
-    gum_interceptor_begin_transaction(interceptor);
-    GumReplaceReturn ret_initfx = gum_interceptor_replace_fast(
-        interceptor,
-        GSIZE_TO_POINTER(initFX_addr),
-        (gpointer)hooked_initFX,
-        (gpointer*)&original_initFX
-    );
-    gum_interceptor_end_transaction(interceptor);
-    if (ret_initfx == GUM_REPLACE_OK) {
-        LOGI("✅ Hook UI_FX::initFX 成功");
-    } else {
-        LOGE("❌ Hook UI_FX::initFX 失败: 错误码 %d", ret_initfx);
-    }
+// ============================
+// 批量 Hook 安装
+// ============================
 
+// 单个目标的安装结果
+struct HookResult {
+    const char* name;
+    GumAddress address;         // 0 表示目标未解析，未尝试安装
+    GumReplaceReturn status;
     
-    GumAddress sendData_addr = base_addr + 0x3b51dc;
-    LOGI("尝试 Hook sendData @ 0x%lx (base: 0x%lx + 0x3b51dc)", sendData_addr, base_addr);
-    
-    gum_interceptor_begin_transaction(interceptor);
-    GumReplaceReturn ret1 = gum_interceptor_replace_fast(
-        interceptor,
-        GSIZE_TO_POINTER(sendData_addr),
-        (gpointer)hooked_sendData,
-        (gpointer*)&original_sendData
-    );
-    gum_interceptor_end_transaction(interceptor);
-    
-    if (ret1 == GUM_REPLACE_OK) {
-        LOGI("✅ Hook sendData 成功");
-    } else {
-        LOGE("❌ Hook sendData 失败: 错误码 %d", ret1);
-    }
-    
-    // Hook 2: CurlHttp::onHttpRequestCompleted (0x3bafa4)
-    GumAddress onHttpCompleted_addr = base_addr + 0x3bafa4;
-    LOGI("尝试 Hook onHttpRequestCompleted @ 0x%lx", onHttpCompleted_addr);
-    
-    gum_interceptor_begin_transaction(interceptor);
-    GumReplaceReturn ret2 = gum_interceptor_replace_fast(
-        interceptor,
-        GSIZE_TO_POINTER(onHttpCompleted_addr),
-        (gpointer)hooked_onHttpCompleted,
-        (gpointer*)&original_onHttpCompleted
-    );
-    gum_interceptor_end_transaction(interceptor);
-    
-    if (ret2 == GUM_REPLACE_OK) {
-        LOGI("✅ Hook onHttpRequestCompleted 成功");
-    } else {
-        LOGE("❌ Hook onHttpRequestCompleted 失败: 错误码 %d", ret2);
+    bool ok() const { return address != 0 && status == GUM_REPLACE_OK; }
+};
+
+// Hook 计划：先收集一个引擎的全部目标，再在同一个 Interceptor 事务中安装，
+// 由 end_transaction 统一完成线程挂起、按页修改保护与指令缓存刷新
+class HookPlan {
+public:
+    HookPlan& add(const char* name, GumAddress address, gpointer replacement, gpointer* original) {
+        targets_.push_back({name, address, replacement, original});
+        return *this;
     }
-    
-    // Hook 3: CurlHttp::parseJson (0x3b6e74)
-    GumAddress parseJson_addr = base_addr + 0x3b6e74;
-    LOGI("尝试 Hook parseJson @ 0x%lx", parseJson_addr);
-    
-    gum_interceptor_begin_transaction(interceptor);
-    GumReplaceReturn ret3 = gum_interceptor_replace_fast(
-        interceptor,
-        GSIZE_TO_POINTER(parseJson_addr),
-        (gpointer)hooked_parseJson,
-        (gpointer*)&original_parseJson
-    );
-    gum_interceptor_end_transaction(interceptor);
-    
-    if (ret3 == GUM_REPLACE_OK) {
-        LOGI("✅ Hook parseJson 成功");
-    } else {
-        LOGE("❌ Hook parseJson 失败: 错误码 %d", ret3);
+
+    bool empty() const { return targets_.empty(); }
+
+    std::vector<HookResult> install() {
+        std::vector<HookResult> results;
+        results.reserve(targets_.size());
+
+        GumInterceptor* interceptor = gum_interceptor_obtain();
+        gum_interceptor_begin_transaction(interceptor);
+        for (const Target& target : targets_) {
+            GumReplaceReturn status = GUM_REPLACE_WRONG_SIGNATURE;
+            if (target.address != 0) {
+                status = gum_interceptor_replace_fast(interceptor, GSIZE_TO_POINTER(target.address),
+                                                      target.replacement, target.original);
+            }
+            results.push_back({target.name, target.address, status});
+        }
+        gum_interceptor_end_transaction(interceptor);
+
+        targets_.clear();
+        return results;
     }
-    
-    // Hook 4: Json_create (0x62ad8c)
-    GumAddress json_create_addr = base_addr + 0x62ad8c;
-    LOGI("尝试 Hook Json_create @ 0x%lx", json_create_addr);
-    
-    gum_interceptor_begin_transaction(interceptor);
-    GumReplaceReturn ret4 = gum_interceptor_replace_fast(
-        interceptor,
-        GSIZE_TO_POINTER(json_create_addr),
-        (gpointer)hooked_json_create,
-        (gpointer*)&original_json_create
-    );
-    gum_interceptor_end_transaction(interceptor);
-    
-    if (ret4 == GUM_REPLACE_OK) {
-        LOGI("✅ Hook Json_create 成功");
-    } else {
-        LOGE("❌ Hook Json_create 失败: 错误码 %d", ret4);
+
+private:
+    struct Target {
+        const char* name;
+        GumAddress address;
+        gpointer replacement;
+        gpointer* original;
+    };
+
+    std::vector<Target> targets_;
+};
+
+// 汇总输出安装结果：一行总览，失败项逐条说明
+static size_t logHookResults(const char* plan_name, const std::vector<HookResult>& results) {
+    size_t succeeded = std::count_if(results.begin(), results.end(),
+        [](const HookResult& r) { return r.ok(); });
+    LOGI("🎯 %s: %zu/%zu 个 Hook 安装成功", plan_name, succeeded, results.size());
+    for (const HookResult& r : results) {
+        if (r.ok()) {
+            LOGD("  ✅ %s @ 0x%lx", r.name, r.address);
+        } else if (r.address == 0) {
+            LOGD("  ⚠️ %s: 未解析到地址，跳过", r.name);
+        } else {
+            LOGE("  ❌ %s @ 0x%lx: 错误码 %d", r.name, r.address, r.status);
+        }
     }
-    
-    // Hook 5: Json_dispose (查找符号)
-    // 先尝试通过符号查找
-    GumAddress json_dispose_addr = 0;
-    
-    gum_module_enumerate_exports(module, 
-        [](const GumExportDetails* details, gpointer user_data) {
-            GumAddress* addr = (GumAddress*)user_data;
-            std::string symbol_name(details->name);
+    return succeeded;
+}
+
+// ============================
+// 声明式 Hook 注册表
+// ============================
+
+// 目标地址的解析方式
+enum class HookResolver : uint8_t {
+    OFFSET,         // 模块基址 + 固定偏移
+    SYMBOL_TARGET,  // 符号索引目标表（kSymbolTargets）的匹配结果，成功后写入偏移缓存
+    EXPORT,         // 按名称查找导出符号
+    CUSTOM,         // 只由解析函数给出地址
+};
+
+// 自定义/后备解析函数，失败返回 0
+using HookResolveFunc = GumAddress (*)(GumModule* module);
+
+// 注册表条目，由下方的 hookAtOffset/hookSymbolTarget/hookExport/hookCustom 构造，整张表是编译期常量。
+// 函数指针不能在常量表达式里转换成 gpointer（reinterpret_cast 不是常量表达式），
+// 所以替换函数以模板参数传入，条目里只存一个类型化 thunk，安装时才调用它擦除类型；
+// trampoline 槽是对象指针，转换成 void* 本身就是常量表达式
+struct HookSpec {
+    const char* name;
+    HookResolver resolver;
+    GumAddress offset;          // OFFSET
+    SymbolTargetId target;      // SYMBOL_TARGET
+    const char* symbol;         // EXPORT
+    HookResolveFunc fallback;   // 主解析失败时调用；CUSTOM 时为唯一的解析方式
+    gpointer (*replacement)();  // 返回擦除为 gpointer 的替换函数
+    void* original;             // trampoline 槽（函数指针变量）的地址
+};
+
+template <auto Replacement>
+static gpointer erasedReplacement() {
+    return reinterpret_cast<gpointer>(Replacement);
+}
+
+// 编译期检查替换函数与 trampoline 槽的签名一致
+template <auto Replacement, typename Slot>
+static constexpr HookSpec makeHookSpec(const char* name, HookResolver resolver, Slot* original) {
+    static_assert(std::is_pointer_v<Slot> && std::is_function_v<std::remove_pointer_t<Slot>>,
+                  "trampoline 槽必须是函数指针");
+    static_assert(std::is_same_v<Slot, decltype(Replacement)>,
+                  "替换函数签名与 trampoline 槽类型不一致");
+    return HookSpec{name, resolver, 0, SymbolTargetId{}, nullptr, nullptr, &erasedReplacement<Replacement>, original};
+}
+
+template <auto Replacement, typename Slot>
+static constexpr HookSpec hookAtOffset(const char* name, GumAddress offset, Slot* original) {
+    HookSpec spec = makeHookSpec<Replacement>(name, HookResolver::OFFSET, original);
+    spec.offset = offset;
+    return spec;
+}
+
+template <auto Replacement, typename Slot>
+static constexpr HookSpec hookSymbolTarget(const char* name, SymbolTargetId target, Slot* original,
+                                           HookResolveFunc fallback = nullptr) {
+    HookSpec spec = makeHookSpec<Replacement>(name, HookResolver::SYMBOL_TARGET, original);
+    spec.target = target;
+    spec.fallback = fallback;
+    return spec;
+}
+
+template <auto Replacement, typename Slot>
+static constexpr HookSpec hookExport(const char* name, const char* symbol, Slot* original,
+                                     HookResolveFunc fallback = nullptr) {
+    HookSpec spec = makeHookSpec<Replacement>(name, HookResolver::EXPORT, original);
+    spec.symbol = symbol;
+    spec.fallback = fallback;
+    return spec;
+}
+
+template <auto Replacement, typename Slot>
+static constexpr HookSpec hookCustom(const char* name, HookResolveFunc resolve, Slot* original) {
+    HookSpec spec = makeHookSpec<Replacement>(name, HookResolver::CUSTOM, original);
+    spec.fallback = resolve;
+    return spec;
+}
+
+// 解析单个条目的目标地址，失败返回 0
+static GumAddress resolveHookSpec(GumModule* module, const HookSpec& spec, bool* from_cache) {
+    *from_cache = false;
+    GumAddress address = 0;
+    
+    switch (spec.resolver) {
+        case HookResolver::OFFSET:
+            address = gum_module_get_range(module)->base_address + spec.offset;
+            break;
             
-            if (symbol_name.find("Json_dispose") != std::string::npos) {
-                *addr = details->address;
-                LOGI("✓ 找到 Json_dispose 符号: %s @ 0x%lx", details->name, details->address);
-                return (gboolean)FALSE; // 停止枚举
+        case HookResolver::SYMBOL_TARGET: {
+            // 缓存以条目名为键；命中时无需建立符号索引
+            address = SymbolCache::instance().lookup(module, spec.name);
+            if (address != 0) {
+                *from_cache = true;
+                break;
             }
-            
-            return (gboolean)TRUE; // 继续枚举
-        }, 
-        &json_dispose_addr);
-    
-    if (json_dispose_addr != 0) {
-        gum_interceptor_begin_transaction(interceptor);
-        GumReplaceReturn ret5 = gum_interceptor_replace_fast(
-            interceptor,
-            GSIZE_TO_POINTER(json_dispose_addr),
-            (gpointer)hooked_json_dispose,
-            (gpointer*)&original_json_dispose
-        );
-        gum_interceptor_end_transaction(interceptor);
-        
-        if (ret5 == GUM_REPLACE_OK) {
-            LOGI("✅ Hook Json_dispose 成功");
-        } else {
-            LOGE("❌ Hook Json_dispose 失败: 错误码 %d", ret5);
+            // 同一模块的所有目标在建立符号索引时已一起匹配
+            std::shared_ptr<const SymbolIndex> symbols = SymbolIndex::forModule(module);
+            if (const SymbolEntry* match = symbols->target(spec.target)) {
+                LOGI("✓ %s 匹配到符号: %s @ 0x%lx", spec.name, symbols->cName(*match), match->address);
+                address = match->address;
+            }
+            break;
         }
-    } else {
-        LOGD("⚠️ 未找到 Json_dispose 符号（不影响核心功能）");
+            
+        case HookResolver::EXPORT:
+            address = gum_module_find_export_by_name(module, spec.symbol);
+            break;
+            
+        case HookResolver::CUSTOM:
+            break;
     }
     
-    // Hook 6: Game_Unpack::updateMoney (0x3880c0)
-    GumAddress updateMoney_addr = base_addr + 0x3880c0;
-    LOGI("尝试 Hook updateMoney @ 0x%lx", updateMoney_addr);
-    
-    gum_interceptor_begin_transaction(interceptor);
-    GumReplaceReturn ret6 = gum_interceptor_replace_fast(
-        interceptor,
-        GSIZE_TO_POINTER(updateMoney_addr),
-        (gpointer)hooked_updateMoney,
-        (gpointer*)&original_updateMoney
-    );
-    gum_interceptor_end_transaction(interceptor);
-    
-    if (ret6 == GUM_REPLACE_OK) {
-        LOGI("✅ Hook updateMoney 成功");
-    } else {
-        LOGE("❌ Hook updateMoney 失败: 错误码 %d", ret6);
+    if (address == 0 && spec.fallback) {
+        address = spec.fallback(module);
     }
     
-    // Hook 7: Game_Unpack::updateGold (0x38813c)
-    GumAddress updateGold_addr = base_addr + 0x38813c;
-    LOGI("尝试 Hook updateGold @ 0x%lx", updateGold_addr);
-    
-    gum_interceptor_begin_transaction(interceptor);
-    GumReplaceReturn ret7 = gum_interceptor_replace_fast(
-        interceptor,
-        GSIZE_TO_POINTER(updateGold_addr),
-        (gpointer)hooked_updateGold,
-        (gpointer*)&original_updateGold
-    );
-    gum_interceptor_end_transaction(interceptor);
-    
-    if (ret7 == GUM_REPLACE_OK) {
-        LOGI("✅ Hook updateGold 成功");
-    } else {
-        LOGE("❌ Hook updateGold 失败: 错误码 %d", ret7);
+    // 除自定义解析外，目标必须落在模块范围内（也用于剔除失效的缓存偏移）
+    if (address != 0 && spec.resolver != HookResolver::CUSTOM) {
+        const GumMemoryRange* range = gum_module_get_range(module);
+        if (address < range->base_address || address >= range->base_address + range->size) {
+            LOGE("❌ %s: 地址 0x%lx 超出模块范围 0x%lx-0x%lx", spec.name, address,
+                 range->base_address, range->base_address + range->size);
+            return 0;
+        }
     }
-    
-    LOGI("🌐 网络函数 Hook 完成");
+    return address;
 }
 
-// Hook Cocos2d-x update 函数
-void hookCocos2dxUpdate(GumModule* module) {
-    const std::string cache_key = "Scheduler_update";
-    
-    // 尝试从缓存读取符号名称
-    std::string cached_symbol = readSymbolNameFromCache(cache_key);
+// 解析整张注册表并在一个事务中安装；符号目标的新解析结果写入偏移缓存
+static std::vector<HookResult> installHookTable(GumModule* module, const char* table_name,
+                                                std::span<const HookSpec> specs) {
+    HookPlan plan;
+    std::vector<bool> cached(specs.size());
+    for (size_t i = 0; i < specs.size(); i++) {
+        bool from_cache = false;
+        GumAddress address = resolveHookSpec(module, specs[i], &from_cache);
+        cached[i] = from_cache;
+        plan.add(specs[i].name, address, specs[i].replacement(), static_cast<gpointer*>(specs[i].original));
+    }
     
-    if (!cached_symbol.empty()) {
-        LOGI("使用缓存的符号名进行 Hook: %s", cached_symbol.c_str());
-        
-        // 通过符号名直接查找地址
-        GumAddress symbol_addr = gum_module_find_export_by_name(module, cached_symbol.c_str());
-        
-        if (symbol_addr != 0) {
-            LOGI("✓ 找到符号地址: 0x%lx", symbol_addr);
-            
-            // 保存原始函数指针
-            original_update = (UpdateFunc)symbol_addr;
-            
-            // 使用 Interceptor Hook
-            GumInterceptor* interceptor = gum_interceptor_obtain();
-            
-            gum_interceptor_begin_transaction(interceptor);
-            GumReplaceReturn ret = gum_interceptor_replace_fast(
-                interceptor,
-                GSIZE_TO_POINTER(symbol_addr),
-                (gpointer)hooked_update,
-                (gpointer*)&original_update
-            );
-            gum_interceptor_end_transaction(interceptor);
-            
-            if (ret == GUM_REPLACE_OK) {
-                LOGI("🎯 Hook 成功 (缓存): %s (%.1fx 加速)", cached_symbol.c_str(), g_speed_multiplier);
-                return;
-            } else {
-                LOGE("Hook 失败: 错误码 %d", ret);
-            }
-        } else {
-            LOGE("缓存的符号名无效，重新搜索...");
+    std::vector<HookResult> results = plan.install();
+    for (size_t i = 0; i < specs.size(); i++) {
+        if (results[i].ok() && specs[i].resolver == HookResolver::SYMBOL_TARGET && !cached[i]) {
+            SymbolCache::instance().store(module, specs[i].name, results[i].address);
         }
     }
     
-    // 缓存未命中，重新搜索符号
-    LOGI("搜索 Cocos2d-x Scheduler::update 符号...");
-    
-    // 正则表达式：Scheduler 类的 update 成员函数（大小写敏感）
-    // 匹配格式：...Scheduler...update...
-    std::regex pattern("Scheduler.*update");
-    
-    // 用于传递 cache_key 的结构
-    struct HookContext {
-        bool found;
-        const char* cache_key;
-    } ctx = {false, cache_key.c_str()};
-    
-    gum_module_enumerate_exports(module, 
-        [](const GumExportDetails* details, gpointer user_data) {
-            HookContext* ctx = (HookContext*)user_data;
-            std::string symbol_name(details->name);
-            
-            // 使用正则匹配 Scheduler::update（大小写敏感）
-            std::regex pattern("Scheduler.*update");
-            
-            if (std::regex_search(symbol_name, pattern)) {
-                LOGI("✓ 匹配到符号: %s @ 0x%lx", details->name, details->address);
-                
-                // 保存原始函数指针
-                original_update = (UpdateFunc)details->address;
-                
-                // 使用 Interceptor Hook
-                GumInterceptor* interceptor = gum_interceptor_obtain();
-                
-                gum_interceptor_begin_transaction(interceptor);
-                GumReplaceReturn ret = gum_interceptor_replace_fast(
-                    interceptor,
-                    GSIZE_TO_POINTER(details->address),
-                    (gpointer)hooked_update,
-                    (gpointer*)&original_update
-                );
-                gum_interceptor_end_transaction(interceptor);
-                
-                if (ret == GUM_REPLACE_OK) {
-                    LOGI("🎯 Hook 成功: %s (%.1fx 加速)", details->name, g_speed_multiplier);
-                    
-                    // 保存符号名称到缓存
-                    saveSymbolNameToCache(ctx->cache_key, details->name);
-                    
-                    ctx->found = true;
-                    return (gboolean)FALSE; // 停止枚举
-                } else {
-                    LOGE("Hook 失败: %s (错误码: %d)", details->name, ret);
-                }
-            }
-            
-            return (gboolean)TRUE; // 继续枚举
-        }, 
-        &ctx);
-    
-    bool found = ctx.found;
-    
-    if (!found) {
-        LOGE("未找到 Scheduler::update 符号");
-    }
+    logHookResults(table_name, results);
+    return results;
+}
+
+// Cocos2d-x (C++) 引擎的 Hook 注册表
+static constexpr HookSpec kCocos2dCppHooks[] = {
+    hookSymbolTarget<hooked_update>("Scheduler::update", SymbolTargetId::SCHEDULER_UPDATE, &original_update),
+    // hookAtOffset<hooked_checkMenu>("UI_FX::checkMenu", 0x4aa998, &original_checkMenu),  // 硬编码邀请进度判定（暂不启用）
+    hookAtOffset<hooked_initFX>("UI_FX::initFX", 0x4aac04, &original_initFX),   // 初始化时将邀请进度写为 999
+    hookAtOffset<hooked_sendData>("CurlHttp::sendData", 0x3b51dc, &original_sendData),
+    hookAtOffset<hooked_onHttpCompleted>("CurlHttp::onHttpRequestCompleted", 0x3bafa4, &original_onHttpCompleted),
+    hookAtOffset<hooked_parseJson>("CurlHttp::parseJson", 0x3b6e74, &original_parseJson),
+    hookAtOffset<hooked_json_create>("Json_create", 0x62ad8c, &original_json_create),
+    hookSymbolTarget<hooked_json_dispose>("Json_dispose", SymbolTargetId::JSON_DISPOSE,  // 未找到符号不影响核心功能
+                                          &original_json_dispose),
+    hookAtOffset<hooked_updateMoney>("Game_Unpack::updateMoney", 0x3880c0, &original_updateMoney),
+    hookAtOffset<hooked_updateGold>("Game_Unpack::updateGold", 0x38813c, &original_updateGold),
+};
+
+// Hook Cocos2d-x：加速（Scheduler::update）与网络/数值函数
+void hookCocos2dCpp(GumModule* module) {
+    // 保存基址到全局变量（供 initFX/updateMoney/updateGold 使用）
+    g_cocos2d_base_addr = gum_module_get_range(module)->base_address;
+    LOGI("📍 libcocos2dcpp.so 基址: 0x%lx", g_cocos2d_base_addr);
+    
+    installHookTable(module, "Cocos2d-x", kCocos2dCppHooks);
+    LOGI("⚡ Cocos2d-x 加速倍率: %.1fx", g_speed_multiplier);
 }
 
 // Cocos2d-js evalString 相关
 typedef bool (*EvalStringFunc)(void* script_engine, const char* code, int len, void* value, const char* path);
 static EvalStringFunc original_evalString = nullptr;
 
-// Hook 后的 evalString 函数
-static bool hooked_evalString(void* script_engine, const char* code, int len, void* value, const char* path) {
- 
-    LOGD("length = %d ,%d", len, ++mycount);
-    
-  
-    // 执行原始代码
-    std::string js(code);
-    return original_evalString(script_engine, js.c_str(), js.length(), value, path);
-}
+// evalString 处理阶段：观察者只读源码，改写器可替换源码。默认没有任何阶段，
+// hooked_evalString 原样转发指针与长度，不计时、不复制。
+// 源码长度：len > 0 时为 len，否则按 '\0' 结尾计算
+using EvalStringObserver = void (*)(std::string_view code, const char* path);
+// 改写器（C 接口，由 fg_eval_set_rewriter 注册）：通过 emit(emit_ctx, data, size) 提交新源码，
+// 可多次调用、按顺序拼接；返回非 0 表示使用提交的内容，否则按原源码执行
+using EvalStringEmit = void (*)(void* emit_ctx, const char* data, size_t size);
+using EvalStringRewriter = int (*)(const char* code, size_t length, const char* path, EvalStringEmit emit,
+                                   void* emit_ctx);
 
-// Hook Cocos2d-js evalString 函数
-void hookCocosEvalString(GumModule* module) {
-    Timer timer("hookCocosEvalString");  // ⏱️ 计时开始
-    const std::string cache_key = "ScriptEngine_evalString";
-    
-    // ✅ 读取缓存（带类型）
-    CacheEntry cache = readFromCache(cache_key);
-    timer.checkpoint("读取缓存");  // ⏱️ 检查点
-    
-    // 🎯 根据缓存类型分发
-    if (cache.type == CacheType::SYMBOL) {
-        // 方案1：使用符号名（dlsym 快速查找）
-        LOGI("使用缓存的符号名进行 Hook: %s", cache.value.c_str());
-        
-        const char* module_path = gum_module_get_path(module);
-        void* handle = dlopen(module_path, RTLD_NOLOAD);
-        timer.checkpoint("dlopen");  // ⏱️ 检查点
-        
-        if (handle) {
-            void* symbol_addr = dlsym(handle, cache.value.c_str());
-            timer.checkpoint("dlsym");  // ⏱️ 检查点
-            
-            if (symbol_addr) {
-                LOGI("✓ 找到符号地址: %p (通过 dlsym)", symbol_addr);
-                
-                original_evalString = (EvalStringFunc)symbol_addr;
-                
-                GumInterceptor* interceptor = gum_interceptor_obtain();
-                gum_interceptor_begin_transaction(interceptor);
-                GumReplaceReturn ret = gum_interceptor_replace_fast(
-                    interceptor,
-                    symbol_addr,
-                    (gpointer)hooked_evalString,
-                    (gpointer*)&original_evalString
-                );
-                gum_interceptor_end_transaction(interceptor);
-                dlclose(handle);
-                
-                if (ret == GUM_REPLACE_OK) {
-                    LOGI("🎯 Hook 成功 (符号缓存): %s", cache.value.c_str());
-                    return;
-                } else {
-                    LOGE("Hook 失败: 错误码 %d", ret);
-                }
-            } else {
-                LOGE("dlsym 未找到符号: %s", cache.value.c_str());
-                dlclose(handle);
+class EvalStringPipeline {
+public:
+    bool active() const { return active_.load(std::memory_order_acquire) != 0; }
+    
+    // 注册/注销在 registry_mutex_ 下串行进行；Hook 路径只读原子槽位，不加锁
+    bool addObserver(EvalStringObserver observer) {
+        std::lock_guard<std::mutex> lock(registry_mutex_);
+        // 先检查全部槽位：中间的空槽不代表后面没有同一个观察者
+        for (const std::atomic<EvalStringObserver>& slot : observers_) {
+            if (slot.load(std::memory_order_relaxed) == observer) return true;
+        }
+        for (std::atomic<EvalStringObserver>& slot : observers_) {
+            if (slot.load(std::memory_order_relaxed) == nullptr) {
+                slot.store(observer, std::memory_order_release);
+                active_.fetch_add(1, std::memory_order_acq_rel);
+                return true;
+            }
+        }
+        LOGE("❌ evalString 观察者已满（%zu 个）", kMaxObservers);
+        return false;
+    }
+    
+    void removeObserver(EvalStringObserver observer) {
+        std::lock_guard<std::mutex> lock(registry_mutex_);
+        for (std::atomic<EvalStringObserver>& slot : observers_) {
+            if (slot.load(std::memory_order_relaxed) == observer) {
+                slot.store(nullptr, std::memory_order_release);
+                active_.fetch_sub(1, std::memory_order_acq_rel);
             }
-        } else {
-            LOGE("dlopen 失败: %s", dlerror());
         }
-        
-        LOGI("符号缓存失败，回退到搜索...");
-        
-    } else if (cache.type == CacheType::OFFSET) {
-        // 方案2：使用偏移量（内存搜索结果）
-        // 先获取 JNI 符号地址
-        GumAddress jni_addr = gum_module_find_export_by_name(module, 
-            "Java_com_cocos_lib_JsbBridge_nativeSendToScript");
-        
-        if (jni_addr == 0) {
-            LOGE("未找到 JNI 符号，无法使用偏移缓存");
-        } else {
-            // 将十六进制字符串转换为偏移量
-            char* endptr;
-            gsize offset = strtoull(cache.value.c_str(), &endptr, 16);
-            GumAddress target_addr = jni_addr + offset;
-            
-            LOGI("使用缓存的偏移量: 0x%lx (JNI: 0x%lx + 偏移: 0x%zx)", 
-                 target_addr, jni_addr, offset);
-            
-            original_evalString = (EvalStringFunc)target_addr;
-            
-            GumInterceptor* interceptor = gum_interceptor_obtain();
-            gum_interceptor_begin_transaction(interceptor);
-            GumReplaceReturn ret = gum_interceptor_replace_fast(
-                interceptor,
-                GSIZE_TO_POINTER(target_addr),
-                (gpointer)hooked_evalString,
-                (gpointer*)&original_evalString
-            );
-            gum_interceptor_end_transaction(interceptor);
-            
-            if (ret == GUM_REPLACE_OK) {
-                LOGI("🎯 Hook 成功 (偏移缓存): 0x%lx", target_addr);
-                return;
-            } else {
-                LOGE("Hook 失败 (偏移缓存): 错误码 %d", ret);
+    }
+    
+    // nullptr 取消改写
+    void setRewriter(EvalStringRewriter rewriter) {
+        std::lock_guard<std::mutex> lock(registry_mutex_);
+        EvalStringRewriter previous = rewriter_.exchange(rewriter, std::memory_order_acq_rel);
+        if (!previous && rewriter) active_.fetch_add(1, std::memory_order_acq_rel);
+        if (previous && !rewriter) active_.fetch_sub(1, std::memory_order_acq_rel);
+    }
+    
+    void observe(std::string_view code, const char* path) const {
+        for (const std::atomic<EvalStringObserver>& slot : observers_) {
+            if (EvalStringObserver observer = slot.load(std::memory_order_acquire)) {
+                observer(code, path);
             }
         }
     }
     
-    // 缓存未命中，重新搜索符号
-    LOGI("搜索 Cocos ScriptEngine::evalString 符号...");
-    timer.checkpoint("开始符号枚举");  // ⏱️ 检查点
+    // 改写结果写入调用方提供的 *out（每次调用各自一份，嵌套的 evalString 不会覆盖外层的源码）
+    bool rewrite(std::string_view code, const char* path, std::string* out) const {
+        EvalStringRewriter rewriter = rewriter_.load(std::memory_order_acquire);
+        if (!rewriter) return false;
+        auto emit = [](void* emit_ctx, const char* data, size_t size) {
+            static_cast<std::string*>(emit_ctx)->append(data, size);
+        };
+        return rewriter(code.data(), code.size(), path, emit, out) != 0;
+    }
+    
+private:
+    static constexpr size_t kMaxObservers = 4;
     
-    // 正则表达式：ScriptEngine 类的 evalString 成员函数（大小写敏感）
-    // 匹配格式：...ScriptEngine...evalString...
-    std::regex pattern("ScriptEngine.*evalString");
+    std::mutex registry_mutex_;
+    std::atomic<int> active_{0};
+    std::atomic<EvalStringObserver> observers_[kMaxObservers] = {};
+    std::atomic<EvalStringRewriter> rewriter_{nullptr};
+};
+
+static EvalStringPipeline g_eval_pipeline;
+
+// 观察阶段：把源码写入捕获文件（随 CAPTURE_EVAL_STRING 开关注册/注销）
+static void captureEvalString(std::string_view code, const char* path) {
+    CaptureWriter::instance().append(CAPTURE_EVAL_STRING, path ? std::string_view(path) : std::string_view(),
+                                     code.data(), code.size());
+}
+
+static void syncEvalCaptureStage() {
+    if (CaptureWriter::instance().enabled(CAPTURE_EVAL_STRING)) {
+        g_eval_pipeline.addObserver(captureEvalString);
+    } else {
+        g_eval_pipeline.removeObserver(captureEvalString);
+    }
+}
+
+// Hook 后的 evalString 函数
+static bool hooked_evalString(void* script_engine, const char* code, int len, void* value, const char* path) {
+    // 没有处理阶段时直接转发
+    if (!g_eval_pipeline.active() || !code) {
+        return original_evalString(script_engine, code, len, value, path);
+    }
     
-    // 用于传递 cache_key 的结构
-    struct HookContext {
-        bool found;
-        const char* cache_key;
-        Timer* timer_ptr;
-    } ctx = {false, cache_key.c_str(), &timer};
+    HookProbe probe(HookMetricId::EVAL_STRING);
+    int count = ++mycount;  // LOG 宏的参数在禁用级别下不会求值
+    LOGD("length = %d ,%d", len, count);
     
-    gum_module_enumerate_exports(module, 
-        [](const GumExportDetails* details, gpointer user_data) {
-            HookContext* ctx = (HookContext*)user_data;
-            std::string symbol_name(details->name);
-            
-            // 使用正则匹配 ScriptEngine::evalString（大小写敏感）
-            std::regex pattern("ScriptEngine.*evalString");
-            
-            if (std::regex_search(symbol_name, pattern)) {
-                LOGI("✓ 匹配到符号: %s @ 0x%lx", details->name, details->address);
-                ctx->timer_ptr->checkpoint("找到符号");  // ⏱️ 检查点
-                
-                // 保存原始函数指针
-                original_evalString = (EvalStringFunc)details->address;
-                
-                // 使用 Interceptor Hook
-                GumInterceptor* interceptor = gum_interceptor_obtain();
-                
-                gum_interceptor_begin_transaction(interceptor);
-                GumReplaceReturn ret = gum_interceptor_replace_fast(
-                    interceptor,
-                    GSIZE_TO_POINTER(details->address),
-                    (gpointer)hooked_evalString,
-                    (gpointer*)&original_evalString
-                );
-                gum_interceptor_end_transaction(interceptor);
-                
-                if (ret == GUM_REPLACE_OK) {
-                    LOGI("🎯 Hook 成功: %s (JS 加速注入)", details->name);
-                    
-                    // 保存符号名称到缓存
-                    saveSymbolNameToCache(ctx->cache_key, details->name);
-                    
-                    ctx->found = true;
-                    return (gboolean)FALSE; // 停止枚举
-                } else {
-                    LOGE("Hook 失败: %s (错误码: %d)", details->name, ret);
-                }
-            }
-            
-            return (gboolean)TRUE; // 继续枚举
-        }, 
-        &ctx);
+    std::string_view source(code, len > 0 ? size_t(len) : strlen(code));
+    g_eval_pipeline.observe(source, path);
     
-    bool found = ctx.found;
+    std::string rewritten;
+    if (g_eval_pipeline.rewrite(source, path, &rewritten)) {
+        return probe.callOriginal(original_evalString, script_engine, rewritten.c_str(), int(rewritten.size()),
+                                  value, path);
+    }
+    return probe.callOriginal(original_evalString, script_engine, code, len, value, path);
+}
+
+// 🔍 后备方案：符号缺失时通过内存模式定位 evalString，失败返回 0
+static GumAddress findEvalStringByPattern(GumModule* module, const SymbolIndex& symbols) {
+    // 步骤1：查找 JNI 桥接函数符号
+    GumAddress jni_addr = symbols.findAddress("Java_com_cocos_lib_JsbBridge_nativeSendToScript");
+    
+    if (jni_addr == 0) {
+        LOGE("也未找到 JNI 符号 Java_com_cocos_lib_JsbBridge_nativeSendToScript，放弃");
+        return 0;
+    }
     
-    if (!found) {
-        LOGE("未找到 ScriptEngine::evalString 符号，尝试内存模式搜索...");
-        
-        // 🔍 后备方案：通过内存模式搜索
-        // 步骤1：查找 JNI 桥接函数符号
-        GumAddress jni_addr = gum_module_find_export_by_name(module, 
-            "Java_com_cocos_lib_JsbBridge_nativeSendToScript");
-        
-        if (jni_addr == 0) {
-            LOGE("也未找到 JNI 符号 Java_com_cocos_lib_JsbBridge_nativeSendToScript，放弃");
-            return;
+    LOGI("✓ 找到 JNI 符号地址: 0x%lx", jni_addr);
+    
+    // 步骤2：计算搜索范围（从 JNI 符号到模块末尾）
+    const GumMemoryRange* module_range = gum_module_get_range(module);
+    GumAddress module_end = module_range->base_address + module_range->size;
+    gsize search_size = module_end - jni_addr;
+    
+    LOGI("搜索范围: 0x%lx → 0x%lx (%.2f MB)", 
+         jni_addr, module_end, search_size / 1024.0 / 1024.0);
+    
+    // 步骤3：搜索内存模式
+    // 模式：ret(C0 03 5F D6) + 固定字节(00) + 通配符(?? ??) + 固定字节(39) + ret(C0 03 5F D6)
+    const char* pattern = "C0 03 5F D6 00 ?? ?? 39 C0 03 5F D6";
+    
+    ProfileSpan scan_span("内存模式扫描");
+    
+    // 用于存储匹配结果
+    struct ScanContext {
+        std::vector<GumAddress> results;
+        GumAddress base_addr;
+    } scan_ctx;
+    scan_ctx.base_addr = jni_addr;
+    
+    std::optional<BytePattern> byte_pattern = BytePattern::compile(pattern);
+    if (byte_pattern) {
+        // 只用到地址最低的匹配：多线程分块扫描，找到后提前结束
+        const uint8_t* begin = reinterpret_cast<const uint8_t*>(jni_addr);
+        for (const uint8_t* match : parallelScan(*byte_pattern, begin, begin + search_size, ScanMode::FIRST_LOWEST)) {
+            GumAddress address = reinterpret_cast<GumAddress>(match);
+            scan_ctx.results.push_back(address);
+            LOGI("✓ 匹配模式 @ 0x%lx (偏移: +0x%lx)", address, address - scan_ctx.base_addr);
         }
-        
-        LOGI("✓ 找到 JNI 符号地址: 0x%lx", jni_addr);
-        
-        // 步骤2：计算搜索范围（从 JNI 符号到模块末尾）
-        const GumMemoryRange* module_range = gum_module_get_range(module);
-        GumAddress module_end = module_range->base_address + module_range->size;
-        gsize search_size = module_end - jni_addr;
-        
-        LOGI("搜索范围: 0x%lx → 0x%lx (%.2f MB)", 
-             jni_addr, module_end, search_size / 1024.0 / 1024.0);
-        
-        GumMemoryRange search_range = {
-            .base_address = jni_addr,
-            .size = search_size
-        };
-        
-        // 步骤3：搜索内存模式
-        // 模式：ret(C0 03 5F D6) + 固定字节(00) + 通配符(?? ??) + 固定字节(39) + ret(C0 03 5F D6)
-        const char* pattern = "C0 03 5F D6 00 ?? ?? 39 C0 03 5F D6";
+    } else {
+        // 模式无法编译时交给 gum_memory_scan
         GumMatchPattern* match_pattern = gum_match_pattern_new_from_string(pattern);
-        
         if (!match_pattern) {
             LOGE("无效的内存模式");
-            return;
+            return 0;
         }
         
-        Timer scan_timer("内存模式扫描");
-        
-        // 用于存储匹配结果
-        struct ScanContext {
-            std::vector<GumAddress> results;
-            GumAddress base_addr;
-        } scan_ctx;
-        scan_ctx.base_addr = jni_addr;
+        GumMemoryRange search_range = {
+            .base_address = jni_addr,
+            .size = search_size
+        };
         
         gum_memory_scan(&search_range, match_pattern, 
             [](GumAddress address, gsize size, gpointer user_data) {
@@ -1826,47 +4697,37 @@ void hookCocosEvalString(GumModule* module) {
             &scan_ctx);
         
         gum_match_pattern_unref(match_pattern);
-        
-        LOGI("内存搜索完成，找到 %zu 个匹配", scan_ctx.results.size());
-        
-        // 步骤4：对找到的地址进行 Hook
-        if (!scan_ctx.results.empty()) {
-            // 使用第一个匹配的地址（通常是最接近 JNI 函数的）
-            GumAddress target_addr = scan_ctx.results[0]+0xc;
-            
-            LOGI("使用匹配地址进行 Hook: 0x%lx", target_addr);
-            
-            // 保存原始函数指针
-            original_evalString = (EvalStringFunc)target_addr;
-            
-            // 使用 Interceptor Hook
-            GumInterceptor* interceptor = gum_interceptor_obtain();
-            
-            gum_interceptor_begin_transaction(interceptor);
-            GumReplaceReturn ret = gum_interceptor_replace_fast(
-                interceptor,
-                GSIZE_TO_POINTER(target_addr),
-                (gpointer)hooked_evalString,
-                (gpointer*)&original_evalString
-            );
-            gum_interceptor_end_transaction(interceptor);
-            
-            if (ret == GUM_REPLACE_OK) {
-                LOGI("🎯 Hook 成功 (通过内存搜索): 0x%lx", target_addr);
-                
-                // ✅ 保存偏移量到缓存（相对于 JNI 符号）
-                gsize offset = target_addr - jni_addr;
-                char offset_str[32];
-                snprintf(offset_str, sizeof(offset_str), "0x%zx", offset);
-                saveToCache(cache_key, CacheType::OFFSET, offset_str);
-                LOGI("✓ 已缓存偏移量: +%s (相对于 JNI 符号)", offset_str);
-            } else {
-                LOGE("Hook 失败 (内存搜索): 错误码 %d", ret);
-            }
-        } else {
-            LOGE("内存搜索未找到匹配的模式");
-        }
     }
+    
+    LOGI("内存搜索完成，找到 %zu 个匹配", scan_ctx.results.size());
+    
+    if (scan_ctx.results.empty()) {
+        LOGE("内存搜索未找到匹配的模式");
+        return 0;
+    }
+    
+    // 使用第一个匹配的地址（通常是最接近 JNI 函数的），目标函数紧随模式之后
+    GumAddress target_addr = scan_ctx.results[0] + 0xc;
+    LOGI("使用匹配地址进行 Hook: 0x%lx (JNI 符号 +0x%lx)", target_addr, target_addr - jni_addr);
+    return target_addr;
+}
+
+// 符号缺失时的后备解析：内存模式搜索
+static GumAddress resolveEvalStringByPattern(GumModule* module) {
+    LOGE("未找到 ScriptEngine::evalString 符号，尝试内存模式搜索...");
+    return findEvalStringByPattern(module, *SymbolIndex::forModule(module));
+}
+
+// Cocos2d-js 引擎的 Hook 注册表
+static constexpr HookSpec kCocosJsHooks[] = {
+    hookSymbolTarget<hooked_evalString>("ScriptEngine::evalString", SymbolTargetId::SCRIPT_ENGINE_EVAL,
+                                        &original_evalString, resolveEvalStringByPattern),
+};
+
+// Hook Cocos2d-js evalString 函数
+void hookCocosEvalString(GumModule* module) {
+    ProfileSpan span("hookCocosEvalString");
+    installHookTable(module, "Cocos2d-js", kCocosJsHooks);
 }
 
 // ============================================================================
@@ -1884,76 +4745,85 @@ static Unity_SetTimeScale_Func original_setTimeScale = nullptr;
 
 // Hook 后的 set_timeScale 函数
 static void hooked_setTimeScale(float value) {
+    HookProbe probe(HookMetricId::SET_TIME_SCALE);
     // 将游戏设置的时间缩放值乘以我们的加速倍数
     float modified_value = value * 5;
     LOGI("🎮 Unity Time.timeScale: %.2f -> %.2f (%.1fx 加速)", value, modified_value, g_speed_multiplier);
     
     if (original_setTimeScale) {
-        original_setTimeScale(modified_value);
+        probe.callOriginal(original_setTimeScale, modified_value);
+    }
+}
+
+// 通过 il2cpp_resolve_icall 解析 Time.set_timeScale 地址，失败返回 0（只尝试一次，不等待）
+static GumAddress resolveSetTimeScale(GumModule* module) {
+    // 步骤 1：查找 il2cpp_resolve_icall 符号（只查一次）
+    if (!il2cpp_resolve_icall) {
+        GumModule* il2cpp = gum_process_find_module_by_name("libil2cpp.so");
+        GumAddress resolve_icall_addr = il2cpp ? gum_module_find_export_by_name(il2cpp, "il2cpp_resolve_icall") : 0;
+        if (il2cpp) {
+            g_object_unref(il2cpp);
+        }
+        if (!resolve_icall_addr) {
+            LOGE("未找到 il2cpp_resolve_icall 导出符号");
+            return 0;
+        }
+        LOGI("✓ 找到 il2cpp_resolve_icall @ 0x%lx", resolve_icall_addr);
+        il2cpp_resolve_icall = (il2cpp_resolve_icall_Func)resolve_icall_addr;
+    }
+    
+    // 步骤 2：IL2CPP 运行时初始化完成之前返回空
+    void* time_setTimeScale_addr = il2cpp_resolve_icall("UnityEngine.Time::set_timeScale(System.Single)");
+    if (time_setTimeScale_addr) {
+        LOGI("✓ 找到 Time.set_timeScale @ %p", time_setTimeScale_addr);
     }
+    return GPOINTER_TO_SIZE(time_setTimeScale_addr);
 }
 
-// Hook Unity Time.timeScale
+// Unity 引擎的 Hook 注册表
+static constexpr HookSpec kUnityHooks[] = {
+    hookCustom<hooked_setTimeScale>("UnityEngine.Time::set_timeScale", resolveSetTimeScale, &original_setTimeScale),
+};
+
+static bool installUnityHooks(GumModule* module) {
+    std::vector<HookResult> results = installHookTable(module, "Unity", kUnityHooks);
+    if (!results[0].ok()) {
+        return false;
+    }
+    hooked_setTimeScale(1);
+    LOGI("🎯 Unity Time.timeScale Hook 成功 (%.1fx 加速)", g_speed_multiplier);
+    return true;
+}
+
+// Hook Unity Time.timeScale：IL2CPP 运行时尚未初始化时不占用启动任务线程，
+// 改由后台线程按递增间隔重试（共约 17 秒），解析成功后再安装
 void hookUnityTimeScale(GumModule* module) {
     LOGI("🎮 开始 Hook Unity Time.timeScale...");
     
-    // 步骤 1：查找 il2cpp_resolve_icall 符号
-    module = gum_process_find_module_by_name("libil2cpp.so");
-    GumAddress resolve_icall_addr = gum_module_find_export_by_name(module, "il2cpp_resolve_icall");
-    
-    if (!resolve_icall_addr) {
-        LOGE("未找到 il2cpp_resolve_icall 导出符号");
+    LOGI("正在解析 UnityEngine.Time::set_timeScale...");
+    if (resolveSetTimeScale(module) || !il2cpp_resolve_icall) {
+        installUnityHooks(module);
         return;
     }
     
-    LOGI("✓ 找到 il2cpp_resolve_icall @ 0x%lx", resolve_icall_addr);
-    il2cpp_resolve_icall = (il2cpp_resolve_icall_Func)resolve_icall_addr;
-    
-    // 步骤 2：通过 il2cpp_resolve_icall 解析 Time.set_timeScale 地址（带重试）
-    void* time_setTimeScale_addr = nullptr;
-  
-    int try_count = 1;
-    
-    LOGI("正在解析 UnityEngine.Time::set_timeScale...");
-    
-    while (time_setTimeScale_addr == nullptr && try_count < 10) {
-        sleep(2);  // 等待 200ms
-        
-        // 尝试解析 icall
-        time_setTimeScale_addr = il2cpp_resolve_icall("UnityEngine.Time::set_timeScale(System.Single)");
-        
-        if (time_setTimeScale_addr == nullptr) {
-            LOGI("等待 IL2CPP 运行时初始化... (%d/10)", try_count++);
-        } else {
-            LOGI("✓ 找到 Time.set_timeScale @ %p (尝试 %d 次)", time_setTimeScale_addr, try_count + 1);
+    GumModule* held = GUM_MODULE(g_object_ref(module));
+    std::thread([held] {
+        static constexpr int kRetryDelaysMs[] = {200, 400, 800, 1600, 2000, 2000, 2000, 2000, 2000, 2000, 2000};
+        int attempt = 0;
+        for (int delay_ms : kRetryDelaysMs) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(delay_ms));
+            attempt++;
+            if (il2cpp_resolve_icall("UnityEngine.Time::set_timeScale(System.Single)")) {
+                LOGI("IL2CPP 运行时已就绪（第 %d 次重试）", attempt);
+                installUnityHooks(held);
+                g_object_unref(held);
+                return;
+            }
+            LOGI("等待 IL2CPP 运行时初始化... (%d/%zu)", attempt, std::size(kRetryDelaysMs));
         }
-    }
-    
-    if (time_setTimeScale_addr == nullptr) {
         LOGE("解析 Time.set_timeScale 失败，超时");
-        return;
-    }
-    
-    // 步骤 3：Hook Time.set_timeScale
-    original_setTimeScale = (Unity_SetTimeScale_Func)time_setTimeScale_addr;
-    
-    GumInterceptor* interceptor = gum_interceptor_obtain();
-    
-    gum_interceptor_begin_transaction(interceptor);
-    GumReplaceReturn ret = gum_interceptor_replace_fast(
-        interceptor,
-        time_setTimeScale_addr,
-        (gpointer)hooked_setTimeScale,
-        (gpointer*)&original_setTimeScale
-    );
-    gum_interceptor_end_transaction(interceptor);
-    
-    if (ret == GUM_REPLACE_OK) {
-        hooked_setTimeScale(1);
-        LOGI("🎯 Unity Time.timeScale Hook 成功 (%.1fx 加速)", g_speed_multiplier);
-    } else {
-        LOGE("❌ Unity Time.timeScale Hook 失败: 错误码 %d", ret);
-    }
+        g_object_unref(held);
+    }).detach();
 }
 
 // ============================================================================
@@ -1966,66 +4836,108 @@ typedef int (*LuaL_loadbufferx_Func)(void* L, const char* buff, size_t size,
                                       const char* name, const char* mode);
 static LuaL_loadbufferx_Func original_luaL_loadbufferx = nullptr;
 
+// 已写入捕获文件的 Lua chunk 内容哈希：只插入不删除的无锁开放寻址表。
+// 重复加载同一 chunk 只需一次哈希和一次查找；表满后不再记录，此后的 chunk 照常写入（不去重）。
+class LuaChunkSeenSet {
+public:
+    bool contains(uint64_t hash) const {
+        hash = normalize(hash);
+        for (size_t i = 0, slot = hash & kMask; i < kMaxProbe; i++, slot = (slot + 1) & kMask) {
+            uint64_t value = slots_[slot].load(std::memory_order_acquire);
+            if (value == hash) return true;
+            if (value == 0) return false;
+        }
+        return false;
+    }
+    
+    void insert(uint64_t hash) {
+        hash = normalize(hash);
+        for (size_t i = 0, slot = hash & kMask; i < kMaxProbe; i++, slot = (slot + 1) & kMask) {
+            uint64_t expected = 0;
+            if (slots_[slot].compare_exchange_strong(expected, hash, std::memory_order_acq_rel) ||
+                expected == hash) {
+                return;
+            }
+        }
+    }
+    
+private:
+    static constexpr size_t kCapacity = 16384;      // 128KB
+    static constexpr size_t kMask = kCapacity - 1;
+    static constexpr size_t kMaxProbe = 64;
+    
+    // 0 表示空槽
+    static uint64_t normalize(uint64_t hash) { return hash ? hash : 1; }
+    
+    std::atomic<uint64_t> slots_[kCapacity] = {};
+};
+
+static LuaChunkSeenSet g_lua_chunks_seen;
 
+// 以内容哈希为键写入捕获文件：已写过的内容直接跳过
+static void captureLuaChunk(const char* name, const char* buff, size_t size) {
+    if (!CaptureWriter::instance().enabled(CAPTURE_LUA_CHUNK)) {
+        return;
+    }
+    uint64_t hash = xxh64(buff, size);
+    if (g_lua_chunks_seen.contains(hash)) {
+        LOGD("Lua 内容已保存过: %s (%016llx)", name ? name : "(null)", (unsigned long long)hash);
+        return;
+    }
+    
+    char capture_name[512];
+    snprintf(capture_name, sizeof(capture_name), "%016llx %s", (unsigned long long)hash, name ? name : "");
+    // 入队失败（队列已满）时不记入已见集合，下次加载再尝试
+    if (CaptureWriter::instance().append(CAPTURE_LUA_CHUNK, capture_name, buff, size)) {
+        g_lua_chunks_seen.insert(hash);
+        LOGD("保存 Lua: %s", capture_name);
+    } else {
+        LOGD("保存 Lua 失败（捕获队列已满）: %s", name ? name : "(null)");
+    }
+}
 
 // Hook 后的 luaL_loadbufferx 函数
 static int hooked_luaL_loadbufferx(void* L, const char* buff, size_t size,
                                     const char* name, const char* mode) {
+    HookProbe probe(HookMetricId::LUA_LOADBUFFER);
     // 记录 Lua 脚本加载信息
     LOGI("🔵 luaL_loadbufferx: name=%s, size=%zu, mode=%s", name ? name : "(null)", size, mode ? mode : "(null)");
+    LOGD("调用方: %s", describeAddress(reinterpret_cast<uintptr_t>(__builtin_return_address(0))).c_str());
 
-    // 修改后的 Lua 脚本内容（使用 thread_local 避免多线程问题）
-    thread_local std::string modified_lua;
-    const char* final_buff = buff;
-    size_t final_size = size;
-    bool script_modified = false;
-    
+    // 保存 Lua chunk 到捕获文件
     if (buff && size > 0) {
-        std::string lua_content(buff, size);
-        
-       
+        captureLuaChunk(name, buff, size);
+    }
 
-        // 保存 Lua 文件用于调试
-        #ifdef LOG_TAG
-        FILE* file = NULL;
-        
-        // 构造文件路径: /sdcard/Android/data/{pkg}/cache/{count}[{@sanitized_name}].lua
-        std::string lua_filename = std::string("/sdcard/Android/data/") + g_pkg.c_str() + "/cache/";
-        lua_filename.append(std::to_string(++mycount));
+    return probe.callOriginal(original_luaL_loadbufferx, L, buff, size, name, mode);
+}
 
-        // 当 name 足够长时，附加扁平化的脚本路径，便于区分来源
-        if (name && strlen(name) > 10 && !strstr(name, " ")) {
-            std::string sanitized(name);
-            for (char& ch : sanitized) {
-                if (ch == '/' || ch == '\\') ch = '-';
-            }
-            lua_filename.append(sanitized);
-            if (sanitized.find('.') == std::string::npos) {
-                lua_filename.append(".lua");
-            }
-        } else {
-            lua_filename.append(".lua");
-        }
-        
-        LOGD("保存 Lua: %s", lua_filename.c_str());
-        file = fopen(lua_filename.c_str(), "w+");
-        if (file == NULL) {
-            LOGD("文件创建失败: %s", lua_filename.c_str());
-        } else {
-            // 保存修改后的脚本（如果有修改的话）
-            const char* save_content = script_modified ? modified_lua.c_str() : lua_content.c_str();
-            size_t save_size = script_modified ? modified_lua.length() : lua_content.length();
-            fwrite(save_content, 1, save_size, file);
-            fclose(file);
-            LOGD("Lua 文件保存成功 %s", script_modified ? "(已修改)" : "");
-        }
-        #endif
+// Lua 5.1 只导出 luaL_loadbuffer
+static GumAddress resolveLuaLoadBuffer(GumModule* lua_module) {
+    LOGE("未找到 luaL_loadbufferx 导出符号，尝试搜索 luaL_loadbuffer...");
+    GumAddress loadbuffer_addr = gum_module_find_export_by_name(lua_module, "luaL_loadbuffer");
+    if (!loadbuffer_addr) {
+        LOGE("未找到 luaL_loadbuffer 导出符号");
     }
+    return loadbuffer_addr;
+}
 
-    return original_luaL_loadbufferx(L, final_buff, final_size, name, mode);
+// Lua 模块的 Hook 注册表
+static constexpr HookSpec kLuaHooks[] = {
+    hookExport<hooked_luaL_loadbufferx>("luaL_loadbufferx", "luaL_loadbufferx", &original_luaL_loadbufferx,
+                                        resolveLuaLoadBuffer),
+};
+
+// 在已加载的 Lua 模块上安装 luaL_loadbufferx Hook
+static void hookLuaModule(GumModule* lua_module) {
+    const GumMemoryRange* range = gum_module_get_range(lua_module);
+    LOGI("Lua 模块已加载: %s @ 0x%lx (大小: %zu)", 
+         gum_module_get_name(lua_module), range->base_address, range->size);
+    
+    installHookTable(lua_module, "Lua", kLuaHooks);
 }
 
-// Hook Lua 库
+// Hook Lua 库（模块未加载时注册监听，加载后再 Hook）
 void hookLua(const std::vector<LibraryInfo>& libs) {
     LOGI("🔵 开始搜索 Lua 库...");
     
@@ -2048,70 +4960,11 @@ void hookLua(const std::vector<LibraryInfo>& libs) {
         return;
     }
     
-    // 查找模块（带重试机制，等待模块加载）
-    GumModule* lua_module = nullptr;
-    const int max_retries = 30;  // 最多等待 30 秒
-    int retry_count = 0;
-    
-    while (!lua_module && retry_count < max_retries) {
-        lua_module = gum_process_find_module_by_name(lua_lib_name.c_str());
-        
-        if (!lua_module) {
-            retry_count++;
-            LOGI("Lua 模块 %s 未加载，1 秒后重试 (%d/%d)", 
-                 lua_lib_name.c_str(), retry_count, max_retries);
-            sleep(1);  // 等待 1 秒
-        }
-    }
-    
-    if (!lua_module) {
-        LOGE("等待超时，无法找到 Lua 模块: %s", lua_lib_name.c_str());
-        return;
-    }
-    
-    const GumMemoryRange* range = gum_module_get_range(lua_module);
-    LOGI("Lua 模块已加载: %s @ 0x%lx (大小: %zu)", 
-         lua_lib_name.c_str(), range->base_address, range->size);
-    
-    // 查找 luaL_loadbufferx 导出符号
-    GumAddress loadbufferx_addr = gum_module_find_export_by_name(lua_module, "luaL_loadbufferx");
-    
-    if (!loadbufferx_addr) {
-        LOGE("未找到 luaL_loadbufferx 导出符号，尝试搜索 luaL_loadbuffer...");
-        // 尝试查找 luaL_loadbuffer (Lua 5.1 版本)
-        loadbufferx_addr = gum_module_find_export_by_name(lua_module, "luaL_loadbuffer");
-        if (!loadbufferx_addr) {
-            LOGE("未找到 luaL_loadbuffer 导出符号");
-            g_object_unref(lua_module);
-            return;
-        }
-        LOGI("✓ 找到 luaL_loadbuffer @ 0x%lx", loadbufferx_addr);
-    } else {
-        LOGI("✓ 找到 luaL_loadbufferx @ 0x%lx", loadbufferx_addr);
-    }
-    
-    // 保存原始函数指针
-    original_luaL_loadbufferx = (LuaL_loadbufferx_Func)loadbufferx_addr;
-    
-    // 使用 Interceptor Hook
-    GumInterceptor* interceptor = gum_interceptor_obtain();
-    
-    gum_interceptor_begin_transaction(interceptor);
-    GumReplaceReturn ret = gum_interceptor_replace_fast(
-        interceptor,
-        GSIZE_TO_POINTER(loadbufferx_addr),
-        (gpointer)hooked_luaL_loadbufferx,
-        (gpointer*)&original_luaL_loadbufferx
-    );
-    gum_interceptor_end_transaction(interceptor);
-    
-    if (ret == GUM_REPLACE_OK) {
-        LOGI("🎯 Lua Hook 成功: luaL_loadbufferx @ 0x%lx", loadbufferx_addr);
-    } else {
-        LOGE("❌ Lua Hook 失败: 错误码 %d", ret);
-    }
-    
-    g_object_unref(lua_module);
+    // 模块加载时（或已加载时立即）安装 Hook，不阻塞工作线程
+    ModuleWatcher::instance().watch(lua_lib_name, [](GumModule* lua_module) {
+        hookLuaModule(lua_module);
+    });
+    LOGI("已注册 Lua 模块加载监听: %s", lua_lib_name.c_str());
 }
 
 // Hook 函数分发
@@ -2131,11 +4984,7 @@ void dispatchHook(GameEngine engine, GumModule* module) {
             
         case GameEngine::COCOS2D_CPP:
             LOGI("准备 Hook Cocos2d-x (C++) 加速函数...");
-            hookCocos2dxUpdate(module);
-            
-            // 🌐 Hook 网络函数
-            LOGI("准备 Hook 网络通信函数...");
-            hookNetworkFunctions(module);
+            hookCocos2dCpp(module);
             break;
             
         case GameEngine::COCOS2D_JS:
@@ -2154,131 +5003,217 @@ void dispatchHook(GameEngine engine, GumModule* module) {
     }
 }
 
-// 主工作线程
+// 主工作线程：启动步骤组成依赖图，在独立的小线程池上执行
+//   maps → apk → libs ─┬→ lua
+//                      └→ module ─┬→ symbols
+//                                 └→ engine → dispatch
+// Lua 监听、符号索引与引擎 Hook 互不等待；等待模块加载会长期占用一个线程，
+// 因此不使用 WorkerPool::shared()（并行扫描仍在共享池上执行）。
 void workerThread() {
-    Timer total_timer("工作线程总耗时");  // ⏱️ 总计时开始
+    ProfileSpan total_span("workerThread");
     LOGI("工作线程启动");
-    
-    // 步骤 1：读取 maps 获取私有库
-    LibraryMap library_map = parseMaps();
-    total_timer.checkpoint("步骤1: parseMaps完成");  // ⏱️ 检查点
-    
-    // 步骤 2：查找 libcpp_shared.so 并提取包名
-    std::string package_name;
-    auto it = library_map.find("libcpp_shared.so");
-    if (it != library_map.end()) {
-        package_name = extractPackageName(it->second);
-        g_pkg = package_name;  // 保存到全局变量，供 JS Hook 使用
-        LOGI("从路径提取包名: %s (路径: %s)", package_name.c_str(), it->second.c_str());
-    } else {
-        LOGE("未找到 libcpp_shared.so，无法提取包名");
-        return;
-    }
-    total_timer.checkpoint("步骤2: 提取包名完成");  // ⏱️ 检查点
-    
-    // 步骤 3：根据包名查找 base.apk 路径（带重试）
-    std::string base_apk_path;
-    int retry_count = 0;
-    const int max_retries = 0xfffff; // 最多重试 30 次（30 秒）
-    
-    while (base_apk_path.empty() && retry_count < max_retries) {
-        base_apk_path = findBaseApkPath(library_map, package_name);
+    uint64_t start_ns = total_span.startNs();
+    
+    // 各任务的输出，只由其后继任务读取（由任务图的锁保证可见性）
+    struct StartupState {
+        std::string package_name;
+        std::string base_apk_path;
+        std::string target_lib;
+        GumModule* module = nullptr;
+        GameEngine engine = GameEngine::UNKNOWN;
+    } state;
+    
+    TaskGraph graph;
+    
+    // 步骤 1-2：确定包名（只解析一次）
+    TaskGraph::TaskId maps = graph.add("步骤1-2: 模块索引/确定包名", {}, [&] {
+        refreshModuleIndex();
+        // 此后有新模块加载就在分发线程刷新索引（每批一次），Lua 等后加载的库也能归属地址
+        ModuleWatcher::instance().subscribe([](const std::vector<GumModule*>&) { refreshModuleIndex(); });
+        state.package_name = ProcessIdentity::packageName();
+        if (state.package_name.empty()) {
+            LOGE("无法确定包名");
+            return false;
+        }
+        g_pkg = state.package_name;  // 保存到全局变量，供 JS Hook 使用
+        g_readiness.mark(READY_PACKAGE);
+#if FG_LOG_BINARY
+        AsyncLogger::instance().openBinaryLog("/sdcard/Android/data/" + g_pkg + "/cache/log.bin");
+#endif
+        LOGI("包名: %s", state.package_name.c_str());
+        return true;
+    });
+    
+    // 步骤 3：在 maps 中查找 base.apk（带重试）。两份快照交替读取，
+    // 内容哈希不变时不做任何处理，变化时只检查新增/变化的映射
+    TaskGraph::TaskId apk = graph.add("步骤3: 查找 base.apk", {maps}, [&] {
+        MapsSnapshot previous, current;
+        int retry_count = 0;
+        const int max_retries = 0xfffff;
         
-        if (base_apk_path.empty()) {
+        while (retry_count < max_retries) {
+            if (current.read()) {
+                size_t added = 0, removed = 0, changed = 0;
+                current.diff(previous, [&](const MapsEvent& event) {
+                    switch (event.change) {
+                        case MapsChange::ADDED: added++; break;
+                        case MapsChange::REMOVED: removed++; return;
+                        case MapsChange::CHANGED: changed++; break;
+                    }
+                    if (state.base_apk_path.empty() &&
+                        isBaseApkOf(event.after->path, state.package_name)) {
+                        state.base_apk_path.assign(event.after->path);
+                    }
+                });
+                if (added + removed + changed > 0) {
+                    LOGI("maps 变化: +%zu -%zu ~%zu", added, removed, changed);
+                }
+                std::swap(previous, current);
+            }
+            if (!state.base_apk_path.empty()) break;
+            
             retry_count++;
-            LOGI("未找到 base.apk 路径，1 秒后重试 (%d/%d)", retry_count, max_retries);
             usleep(1);
-            library_map = parseMaps(); // 重新读取 maps
         }
-    }
-    
-    if (base_apk_path.empty()) {
-        LOGE("无法找到 base.apk 路径，放弃");
-        return;
-    }
-    
-    LOGI("找到 base.apk 路径: %s", base_apk_path.c_str());
-    total_timer.checkpoint("步骤3: 找到base.apk完成");  // ⏱️ 检查点
-    
-    // 步骤 4：构造 lib 目录路径
-    // 从 /data/app/~~xxx/pkg-xxx/base.apk 截断为 /data/app/~~xxx/pkg-xxx/
-    size_t last_slash = base_apk_path.rfind('/');
-    std::string app_dir = base_apk_path.substr(0, last_slash + 1);
-    std::string lib_dir = app_dir + "lib/arm64/";
-    
-    LOGI("库目录路径: %s", lib_dir.c_str());
-    
-    // 步骤 5：执行 ls -l 命令，找到最大的库
-    std::string target_lib = findLargestLibrary(lib_dir);
-    total_timer.checkpoint("步骤5: findLargestLibrary完成");  // ⏱️ 检查点
-    // target_lib="libluajapi.so";
-    if (target_lib.empty()) {
-        LOGE("未找到目标库");
-        return;
-    }
-    
-    LOGI("目标库: %s", target_lib.c_str());
-    
-    // 步骤 6：使用 Frida Gum 查找模块（带重试）
-    GumModule* module = nullptr;
-    retry_count = 0;
-    
-    while (!module  ) {
-        module = gum_process_find_module_by_name(target_lib.c_str());
         
-        if (!module) {
-        //    retry_count++;
-           LOGI("模块 %s 未加载，1 秒后重试 (%d/%d)",  target_lib.c_str(), retry_count, max_retries);
-            usleep(1);
+        if (state.base_apk_path.empty()) {
+            LOGE("无法找到 base.apk 路径，放弃（重试 %d 次）", retry_count);
+            return false;
+        }
+        LOGI("找到 base.apk 路径: %s", state.base_apk_path.c_str());
+        return true;
+    });
+    
+    // 步骤 4-5：扫描库目录，找到最大的库
+    TaskGraph::TaskId libs = graph.add("步骤4-5: 扫描库目录", {apk}, [&] {
+        std::string lib_dir = ProcessIdentity::libraryDir(state.base_apk_path);
+        LOGI("库目录路径: %s", lib_dir.c_str());
+        
+        state.target_lib = findLargestLibrary(lib_dir, state.base_apk_path);
+        if (state.target_lib.empty()) {
+            LOGE("未找到目标库");
+            return false;
         }
+        LOGI("目标库: %s", state.target_lib.c_str());
+        return true;
+    });
+    
+    // 步骤 6：注册 Lua 模块监听（与目标模块无关）
+    graph.add("步骤6: Lua Hook", {libs}, [&] {
+        hookLua(libraries);
+        return true;
+    });
+    
+    // 步骤 7：等待目标模块加载（由 dlopen 监听唤醒，不再轮询）。
+    // 最大的库不一定是引擎、也不一定会被加载：限时等待，超时即失败，READY_STARTUP 照常发出
+    TaskGraph::TaskId module = graph.add("步骤7: 等待模块加载", {libs}, [&] {
+        static constexpr int kModuleWaitTimeoutMs = 30000;
+        state.module = ModuleWatcher::instance().waitFor(state.target_lib, kModuleWaitTimeoutMs);
+        if (!state.module) {
+            LOGE("无法找到模块: %s（%d ms 内未加载）", state.target_lib.c_str(), kModuleWaitTimeoutMs);
+            return false;
+        }
+        
+        const GumMemoryRange* range = gum_module_get_range(state.module);
+        LOGI("模块已加载:");
+        LOGI("  名称: %s", gum_module_get_name(state.module));
+        LOGI("  路径: %s", gum_module_get_path(state.module));
+        LOGI("  基址: 0x%lx", range->base_address);
+        LOGI("  大小: %zu 字节", range->size);
+        
+        // 目标模块及其依赖已映射，刷新索引供地址归属查询
+        refreshModuleIndex();
+        return true;
+    });
+    
+    // 步骤 8：预建符号索引（Hook 解析需要时直接复用，仍在构建时等待其完成）
+    graph.add("步骤8: 符号索引", {module}, [&] {
+        SymbolIndex::forModule(state.module);
+        return true;
+    });
+    
+    // 步骤 9：识别游戏引擎
+    TaskGraph::TaskId engine = graph.add("步骤9: 识别引擎", {module}, [&] {
+        state.engine = identifyGameEngine(state.module);
+        return true;
+    });
+    
+    // 步骤 10：分发 Hook
+    graph.add("步骤10: 分发 Hook", {engine}, [&] {
+        dispatchHook(state.engine, state.module);
+        LOGI("⏱️ 启动到引擎 Hook 完成: %.2f ms", (profilerNowNs() - start_ns) / 1e6);
+        return true;
+    });
+    
+    {
+        WorkerPool pool(3);
+        graph.run(pool);
     }
     
-    if (!module) {
-        LOGE("无法找到模块: %s", target_lib.c_str());
-        return;
+    // 释放模块
+    if (state.module) {
+        g_object_unref(state.module);
     }
-    
-    total_timer.checkpoint("步骤6: 找到模块完成");  // ⏱️ 检查点
-    
-    // 获取模块信息
-    const gchar* module_name = gum_module_get_name(module);
-    const gchar* module_path = gum_module_get_path(module);
-    const GumMemoryRange* range = gum_module_get_range(module);
-    
-    LOGI("模块已加载:");
-    LOGI("  名称: %s", module_name);
-    LOGI("  路径: %s", module_path);
-    LOGI("  基址: 0x%lx", range->base_address);
-    LOGI("  大小: %zu 字节", range->size);
-    
-    // 步骤 7：识别游戏引擎
-    GameEngine engine = identifyGameEngine(module);
-    total_timer.checkpoint("步骤7: 识别引擎完成");  // ⏱️ 检查点
-    
-    // 步骤 8：尝试lua hook
-    hookLua(libraries);
-    total_timer.checkpoint("步骤9: Lua Hook完成");  // ⏱️ 检查点
-    
-    // 步骤 9：分发 Hook
-    dispatchHook(engine, module);
-    total_timer.checkpoint("步骤8: Hook完成");  // ⏱️ 检查点
-    
-    // 步骤 9：释放模块
-    g_object_unref(module);
     LOGI("工作流程完成");
 }
 
+// 按需导出 span trace 与汇总（例如通过 dlsym 调用）；path 为空时写入应用缓存目录
+extern "C" __attribute__((visibility("default"))) int fg_profiler_dump(const char* path) {
+    if (!path && !g_readiness.waitFor(READY_PACKAGE, 1000)) {
+        LOGE("❌ 包名未知，无法确定 trace 路径");
+        return -1;
+    }
+    std::string trace_path = path ? path : "/sdcard/Android/data/" + g_pkg + "/cache/trace.json";
+    SpanProfiler::instance().logSummary();
+    return SpanProfiler::instance().writeTrace(trace_path.c_str()) ? 0 : -1;
+}
+
+// 开关 Hook 调用的 span 记录（默认关闭；Hook 直方图不受影响）
+extern "C" __attribute__((visibility("default"))) void fg_profiler_trace_hooks(int enable) {
+    g_hook_spans_enabled.store(enable != 0, std::memory_order_relaxed);
+}
+
+// 开关 HTTP 响应捕获（默认开启）：即捕获掩码中的 CAPTURE_HTTP_RESPONSE 位，关闭后仍打印响应预览
+extern "C" __attribute__((visibility("default"))) void fg_http_capture_enable(int enable) {
+    CaptureWriter::instance().setEnabled(CAPTURE_HTTP_RESPONSE, enable != 0);
+}
+
+// 设置写入捕获文件的记录类型（bit = CaptureKind，默认网络请求/响应与 Lua chunk）
+extern "C" __attribute__((visibility("default"))) void fg_capture_set_mask(uint32_t mask) {
+    CaptureWriter::instance().setMask(mask);
+    syncEvalCaptureStage();
+}
+
+// 等待启动状态（bits 为 ReadyBits 组合，timeout_ms < 0 一直等待），就绪返回 1，超时返回 0
+extern "C" __attribute__((visibility("default"))) int fg_wait_ready(uint32_t bits, int timeout_ms) {
+    return g_readiness.waitFor(bits, timeout_ms) ? 1 : 0;
+}
+
+// 注册 evalString 改写器（nullptr 取消），回调约定见 EvalStringRewriter
+extern "C" __attribute__((visibility("default"))) void fg_eval_set_rewriter(EvalStringRewriter rewriter) {
+    g_eval_pipeline.setRewriter(rewriter);
+}
+
+// 按需输出各 Hook 的调用次数与自身耗时分布
+extern "C" __attribute__((visibility("default"))) void fg_hook_stats_dump() {
+    HookMetrics::instance().logSummary();
+}
+
 // init_array 初始化函数
+// 只启动工作线程：System.loadLibrary 所在的 Java 线程不等待 gum 初始化
 __attribute__((constructor))
 static void init() {
-    LOGI("初始化 Frida Gum");
-    
-    // 初始化 Frida Gum
-    gum_init_embedded();
-    
-    // 创建工作线程（使用 C++ std::thread）
-    std::thread worker(workerThread);
-    worker.detach(); // 分离线程
-    LOGI("工作线程已启动（分离模式）");
+    std::thread([] {
+        {
+            ProfileSpan span("gum_init_embedded");
+            gum_init_embedded();
+        }
+        g_readiness.mark(READY_GUM);
+        LOGI("Frida Gum 初始化完成（工作线程）");
+        
+        workerThread();
+        g_readiness.mark(READY_STARTUP);
+        SpanProfiler::instance().logSummary();
+    }).detach();
 }
 
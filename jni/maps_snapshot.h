@@ -0,0 +1,354 @@
+// /proc/self/maps 零拷贝解析
+// 设备端（jni/main.cpp）与主机端基准工具（tools/bench_maps.cpp、tools/bench_discovery.cpp）共用，只依赖标准库与 POSIX
+
+#pragma once
+
+#include <cstdint>
+#include <cstddef>
+#include <cerrno>
+#include <cstring>
+#include <algorithm>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include <fcntl.h>
+#include <unistd.h>
+
+#include "xxh64.h"
+
+// 映射权限位
+enum MapPerm : uint8_t {
+    MAP_PERM_READ   = 1 << 0,
+    MAP_PERM_WRITE  = 1 << 1,
+    MAP_PERM_EXEC   = 1 << 2,
+    MAP_PERM_SHARED = 1 << 3,   // 's'，否则为 'p'（私有）
+};
+
+// 单条映射记录（path 指向 MapsSnapshot 内部缓冲区，快照存活期间有效）
+struct MapRecord {
+    uintptr_t start;
+    uintptr_t end;
+    uint64_t offset;
+    uint64_t inode;
+    std::string_view path;  // 匿名映射为空
+    uint8_t perms;          // MapPerm 位掩码
+};
+
+// 两个快照之间的映射变化
+enum class MapsChange : uint8_t {
+    ADDED,      // 只在新快照中
+    REMOVED,    // 只在旧快照中
+    CHANGED,    // 起始地址相同，但范围/权限/偏移/文件不同
+};
+
+struct MapsEvent {
+    MapsChange change;
+    const MapRecord* before;    // ADDED 时为空
+    const MapRecord* after;     // REMOVED 时为空
+};
+
+// maps 快照：一次读入可复用缓冲区，原地切分字段，不为每行分配字符串
+// 缓冲区与记录数组的容量在多次 read() 之间保留，稳态下无堆分配
+class MapsSnapshot {
+public:
+    MapsSnapshot() = default;
+    MapsSnapshot(const MapsSnapshot&) = delete;
+    MapsSnapshot& operator=(const MapsSnapshot&) = delete;
+    MapsSnapshot(MapsSnapshot&&) = default;
+    MapsSnapshot& operator=(MapsSnapshot&&) = default;
+
+    // 读取并解析，失败返回 false（原有记录被清空）。
+    // 内容与上次读取完全相同且缓冲区未搬迁时跳过解析，原有记录继续有效
+    bool read(const char* maps_path = "/proc/self/maps") {
+        uint64_t previous_hash = hash_;
+        size_t previous_size = size_;
+        const char* previous_data = buffer_.data();
+        bool had_records = !records_.empty();
+        records_.swap(unchanged_records_);  // 内容未变时换回
+        records_.clear();
+        size_ = 0;
+        hash_ = 0;
+
+        int fd = open(maps_path, O_RDONLY | O_CLOEXEC);
+        if (fd < 0) {
+            return false;
+        }
+
+        if (buffer_.size() < kInitialBufferSize) {
+            buffer_.resize(kInitialBufferSize);
+        }
+
+        // procfs 每次 read 最多返回一页左右，循环读到 EOF；缓冲区只增不减
+        for (;;) {
+            if (size_ == buffer_.size()) {
+                buffer_.resize(buffer_.size() * 2);
+            }
+            ssize_t n = ::read(fd, buffer_.data() + size_, buffer_.size() - size_);
+            if (n < 0) {
+                if (errno == EINTR) continue;
+                close(fd);
+                size_ = 0;
+                return false;
+            }
+            if (n == 0) break;
+            size_ += static_cast<size_t>(n);
+        }
+        close(fd);
+        // 解析按 8 字节一组读取：末尾留出余量，并放一个 '\n' 哨兵，字段扫描无需再检查边界
+        if (buffer_.size() < size_ + kParseSlack) {
+            buffer_.resize(size_ + kParseSlack);
+        }
+        memset(buffer_.data() + size_, 0, kParseSlack);
+        buffer_[size_] = '\n';
+
+        hash_ = xxh64(buffer_.data(), size_);
+        if (had_records && hash_ == previous_hash && size_ == previous_size && buffer_.data() == previous_data) {
+            records_.swap(unchanged_records_);
+            return true;
+        }
+        parse();
+        return true;
+    }
+
+    // 原始文本的 XXH64，读取失败时为 0
+    uint64_t contentHash() const { return hash_; }
+
+    // 与旧快照比较，按地址顺序对每条变化调用 on_event(const MapsEvent&)，返回变化条数。
+    // 两份记录都按起始地址排序，一次归并即可；内容哈希相同时直接返回 0
+    template <typename Fn>
+    size_t diff(const MapsSnapshot& previous, Fn&& on_event) const {
+        if (hash_ == previous.hash_ && size_ == previous.size_) {
+            return 0;
+        }
+        const std::vector<MapRecord>& before = previous.records_;
+        const std::vector<MapRecord>& after = records_;
+        size_t i = 0, j = 0, events = 0;
+        while (i < before.size() || j < after.size()) {
+            if (j == after.size() || (i < before.size() && before[i].start < after[j].start)) {
+                on_event(MapsEvent{MapsChange::REMOVED, &before[i++], nullptr});
+            } else if (i == before.size() || after[j].start < before[i].start) {
+                on_event(MapsEvent{MapsChange::ADDED, nullptr, &after[j++]});
+            } else {
+                const MapRecord& a = before[i++];
+                const MapRecord& b = after[j++];
+                if (a.end == b.end && a.perms == b.perms && a.offset == b.offset && a.inode == b.inode &&
+                    a.path == b.path) {
+                    continue;
+                }
+                on_event(MapsEvent{MapsChange::CHANGED, &a, &b});
+            }
+            events++;
+        }
+        return events;
+    }
+
+    // 按起始地址升序排列
+    const std::vector<MapRecord>& records() const { return records_; }
+
+    // 原始文本
+    std::string_view raw() const { return std::string_view(buffer_.data(), size_); }
+
+private:
+    static constexpr size_t kInitialBufferSize = 256 * 1024;
+    static constexpr size_t kParseSlack = 16;
+
+    // 以下按 8 字节一组（SWAR）处理字段：逐字节循环在每行约 50 个字段字符上占了解析的大半。
+    // 读取可越过行尾，由 kParseSlack 保证不越出缓冲区；每组只使用遇到的第一个分隔符之前的字节
+    static uint64_t load8(const char* p) {
+        uint64_t word;
+        memcpy(&word, p, sizeof(word));
+        return word;
+    }
+
+    static constexpr uint64_t kOnes = 0x0101010101010101ull;
+
+    // 每个字段字节对应位置的 bit0 置 1，其余为 0；返回第一个非字段字节的下标（8 表示全部是）
+    static unsigned fieldLength(uint64_t field_bits) {
+        uint64_t stop = (field_bits & kOnes) ^ kOnes;
+        return stop ? unsigned(__builtin_ctzll(stop)) / 8 : 8;
+    }
+
+    // 十六进制数字 '0'-'9'（0x3X）与 'a'-'f'（0x6X）都有 0x10 或 0x40 位，'-'、' '、'\n' 都没有
+    static unsigned hexLength(uint64_t word) {
+        // 与 isHexish 相同的判定，按字节并行
+        uint64_t bits = word >> 4;
+        return fieldLength(bits | (bits >> 2));
+    }
+
+    // 前 n（1..8）个字符组成的十六进制数
+    static uint64_t hexValue(uint64_t word, unsigned n) {
+        // 每字节换算为数值（字母 +9），再左移让 n 个数字落在高位、前面补 0
+        uint64_t digits = (word & 0x0f0f0f0f0f0f0f0full) + 9 * ((word >> 6) & kOnes);
+        digits = n == 8 ? digits : (digits << (8 * (8 - n)));
+        // 相邻字节两两合并：2 位 → 4 位 → 8 位（小端：低地址字节是高位数字）
+        digits = ((digits & 0x00ff00ff00ff00ffull) << 4 | ((digits >> 8) & 0x00ff00ff00ff00ffull)) &
+                 0x00ff00ff00ff00ffull;
+        digits = ((digits & 0x0000ffff0000ffffull) << 8 | ((digits >> 16) & 0x0000ffff0000ffffull)) &
+                 0x0000ffff0000ffffull;
+        return (digits & 0xffffffffull) << 16 | (digits >> 32);
+    }
+
+    static bool isHexish(char c) { return (c & 0x50) != 0; }
+
+    static uint64_t parseHex(const char*& p) {
+        uint64_t word = load8(p);
+        unsigned n = hexLength(word);
+        if (n < 8) {
+            p += n;
+            return n ? hexValue(word, n) : 0;
+        }
+        // 正好 8 位（偏移固定按 %08llx 输出）只需再看一个字节
+        uint64_t high = hexValue(word, 8);
+        if (!isHexish(p[8])) {
+            p += 8;
+            return high;
+        }
+        // 超过 8 位（64 位地址通常 10~12 位），最多 16 位
+        word = load8(p + 8);
+        n = hexLength(word);
+        p += 8 + n;
+        return n == 0 ? high : (high << (4 * n)) | hexValue(word, n);
+    }
+
+    // 十进制数字 0x30-0x39 都有 0x10 位，' ' 与 '\n' 没有
+    static uint64_t parseDec(const char*& p) {
+        uint64_t value = 0;
+        for (int group = 0; group < 3; ++group) {     // 最多 24 位，inode 实际不超过 20 位
+            uint64_t word = load8(p);
+            unsigned n = fieldLength(word >> 4);
+            if (n == 0) break;
+            uint64_t digits = word - 0x3030303030303030ull;
+            digits = n == 8 ? digits : (digits << (8 * (8 - n)));
+            // 8 位十进制合并（低地址字节是高位数字）
+            digits = digits * 10 + (digits >> 8);
+            digits = (((digits & 0x000000ff000000ffull) * (100 + (1000000ull << 32))) +
+                      (((digits >> 16) & 0x000000ff000000ffull) * (1 + (10000ull << 32)))) >> 32;
+            static constexpr uint64_t kPow10[] = {1, 10, 100, 1000, 10000, 100000, 1000000, 10000000, 100000000};
+            value = value * kPow10[n] + digits;
+            p += n;
+            if (n < 8) break;
+        }
+        return value;
+    }
+
+    // 跳过空格：inode 与路径之间的对齐空格通常有二三十个
+    static void skipSpaces(const char*& p) {
+        constexpr uint64_t kEightSpaces = 0x2020202020202020ull;
+        for (;;) {
+            uint64_t other = load8(p) ^ kEightSpaces;
+            if (other) {
+                p += __builtin_ctzll(other) / 8;
+                return;
+            }
+            p += 8;
+        }
+    }
+
+    // 字段之间内核只输出一个空格；多出的空格（手写的输入）走慢路径
+    static void skipSeparator(const char*& p) {
+        if (*p == ' ') ++p;
+        if (*p == ' ') skipSpaces(p);
+    }
+
+    // 设备号 "fd:01"：数字、小写十六进制字母与 ':' 都满足 hexLength 的判定，一次跳过
+    static void skipDevice(const char*& p) {
+        unsigned n = hexLength(load8(p));
+        p += n;
+        if (n == 8) {
+            while (*p != ' ' && *p != '\n') ++p;
+        }
+    }
+
+    // maps 格式：address perms offset dev inode pathname
+    // 例：7a1c2000-7a1c4000 r-xp 00010000 fd:01 1234   /data/app/.../libfoo.so
+    // 各字段扫描都停在 '\n'（含末尾哨兵）之前，格式异常的行不会越过行尾
+    void parse() {
+        const char* p = buffer_.data();
+        const char* const buf_end = p + size_;
+        records_.reserve(size_ / 64);
+
+        while (p < buf_end) {
+            // 先找行尾：下一行的起点不依赖本行字段的解析结果，CPU 可以把相邻几行的解析重叠执行
+            const char* eol = static_cast<const char*>(memchr(p, '\n', buf_end + 1 - p));
+
+            MapRecord rec;
+            rec.start = parseHex(p);
+            if (*p == '-') ++p;
+            rec.end = parseHex(p);
+            skipSeparator(p);
+
+            // 权限固定 4 个字符；行过短时后面的字节是下一行或哨兵余量，结果只影响这条无效行
+            rec.perms = uint8_t((p[0] == 'r') * MAP_PERM_READ | (p[1] == 'w') * MAP_PERM_WRITE |
+                                (p[2] == 'x') * MAP_PERM_EXEC | (p[3] == 's') * MAP_PERM_SHARED);
+            // 内核按固定宽度输出 "rwxp 00000000 fd:01 "（8 位偏移、2 位主次设备号），先按固定列检查并取偏移，
+            // 这几次读取互不依赖；不符合时（偏移超过 8 位、主设备号 3 位、手写输入）逐字段扫描
+            uint64_t offset_word = load8(p + 5);
+            if (eol - p > 20 && p[4] == ' ' && p[13] == ' ' && p[16] == ':' && p[19] == ' ' &&
+                hexLength(offset_word) == 8) {
+                rec.offset = hexValue(offset_word, 8);
+                p += 20;
+            } else {
+                while (*p != ' ' && *p != '\n') ++p;
+                skipSeparator(p);
+                rec.offset = parseHex(p);
+                skipSeparator(p);
+                skipDevice(p);
+                skipSeparator(p);
+            }
+            rec.inode = parseDec(p);
+            skipSpaces(p);
+
+            // 路径可能包含空格（如 "(deleted)" 后缀），取到行尾。
+            // 格式异常的行上前面的扫描可能停在更早的换行处，路径按空处理
+            rec.path = p < eol ? std::string_view(p, eol - p) : std::string_view();
+
+            if (rec.end > rec.start) {
+                records_.push_back(rec);
+            }
+            p = eol + 1;
+        }
+
+        // 内核按地址顺序输出，通常无需排序
+        auto by_start = [](const MapRecord& a, const MapRecord& b) { return a.start < b.start; };
+        if (!std::is_sorted(records_.begin(), records_.end(), by_start)) {
+            std::sort(records_.begin(), records_.end(), by_start);
+        }
+    }
+
+    std::vector<char> buffer_;
+    size_t size_ = 0;
+    uint64_t hash_ = 0;
+    std::vector<MapRecord> records_;
+    std::vector<MapRecord> unchanged_records_;  // read() 期间暂存上一次的记录
+};
+
+// ============================
+// base.apk 字面匹配（进程身份解析与主机端基准共用）
+// ============================
+
+// 路径是否为 "/<包名>-" 目录下的 base.apk：
+//   /data/app/~~xxx/com.game.pkg-yyy==/base.apk 或 /data/app/com.game.pkg-1/base.apk
+inline bool isBaseApkOf(std::string_view path, std::string_view package_name) {
+    constexpr std::string_view kApkSuffix = "/base.apk";
+    if (package_name.empty() || path.size() <= kApkSuffix.size() + package_name.size() + 2 ||
+        path.compare(path.size() - kApkSuffix.size(), kApkSuffix.size(), kApkSuffix) != 0) {
+        return false;
+    }
+    // 包名必须位于 base.apk 所在目录的开头："/<包名>-"
+    size_t dir_start = path.rfind('/', path.size() - kApkSuffix.size() - 1);
+    if (dir_start == std::string_view::npos) return false;
+    std::string_view dir = path.substr(dir_start + 1, path.size() - kApkSuffix.size() - dir_start - 1);
+    return dir.size() > package_name.size() && dir.compare(0, package_name.size(), package_name) == 0 &&
+           dir[package_name.size()] == '-';
+}
+
+// 在快照中查找该包名的 base.apk，未找到返回空串
+inline std::string findBaseApk(const MapsSnapshot& snapshot, std::string_view package_name) {
+    for (const MapRecord& rec : snapshot.records()) {
+        if (isBaseApkOf(rec.path, package_name)) {
+            return std::string(rec.path);
+        }
+    }
+    return "";
+}
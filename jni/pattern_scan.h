@@ -0,0 +1,419 @@
+// 字节模式扫描：BytePattern（兼容 GumMatchPattern 字符串语法的 SIMD 扫描器）、共享线程池与并行区域扫描
+// 设备端（jni/main.cpp）与主机端工具（tools/bench_scan.cpp、tools/check_scan.cpp）共用，只依赖标准库
+
+#pragma once
+
+#include <cstdint>
+#include <cstddef>
+#include <cstring>
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <string_view>
+#include <thread>
+#include <vector>
+
+#if defined(__aarch64__)
+#include <arm_neon.h>
+#define FG_SCAN_SIMD 1
+#elif defined(__AVX2__)
+#include <immintrin.h>
+#define FG_SCAN_SIMD 1
+#elif defined(__SSE2__)
+#include <emmintrin.h>
+#define FG_SCAN_SIMD 1
+#else
+#define FG_SCAN_SIMD 0
+#endif
+
+// ============================
+// SIMD 内存模式扫描
+// ============================
+
+// 编译后的字节模式，兼容 GumMatchPattern 字符串语法：
+//   "C0 03 5F D6 00 ?? ?? 39"  —— ?? 为整字节通配，"3?" / "?F" 为半字节通配
+//   "13 37 00 : 1F FF 00"       —— 冒号后为逐字节掩码
+// 扫描时选两个完整字节作锚点，SIMD 一次比较 16/32 个候选起点，命中后再逐字节校验
+class BytePattern {
+public:
+    static std::optional<BytePattern> compile(std::string_view text) {
+        BytePattern pattern;
+        size_t colon = text.find(':');
+
+        if (!parseTokens(text.substr(0, colon), pattern.bytes_, pattern.mask_) || pattern.bytes_.empty()) {
+            return std::nullopt;
+        }
+
+        if (colon != std::string_view::npos) {
+            std::vector<uint8_t> mask_bytes, mask_mask;
+            if (!parseTokens(text.substr(colon + 1), mask_bytes, mask_mask) ||
+                mask_bytes.size() != pattern.bytes_.size()) {
+                return std::nullopt;
+            }
+            for (size_t i = 0; i < mask_bytes.size(); ++i) {
+                pattern.mask_[i] &= mask_bytes[i];
+            }
+        }
+
+        for (size_t i = 0; i < pattern.bytes_.size(); ++i) {
+            pattern.bytes_[i] &= pattern.mask_[i];
+        }
+
+        pattern.chooseAnchors();
+        return pattern;
+    }
+
+    size_t size() const { return bytes_.size(); }
+
+    // 扫描 [begin, end)，每个匹配调用 on_match(const uint8_t* match)，返回 false 提前结束
+    template <typename OnMatch>
+    void scan(const uint8_t* begin, const uint8_t* end, OnMatch&& on_match) const {
+        const size_t length = bytes_.size();
+        if (end < begin || static_cast<size_t>(end - begin) < length) return;
+        const uint8_t* const last = end - length;  // 最后一个可能的起点
+        const uint8_t* p = begin;
+
+        if (!has_anchor_) {
+            // 没有完整字节可作锚点：逐位置校验
+            for (; p <= last; ++p) {
+                if (verify(p) && !on_match(p)) return;
+            }
+            return;
+        }
+
+        const uint8_t b1 = bytes_[anchor1_];
+        const uint8_t b2 = bytes_[anchor2_];
+
+#if FG_SCAN_SIMD
+        // 向量块覆盖起点 p..p+kLanes-1，需保证两处加载都不越过 end
+        const size_t max_anchor = anchor1_ > anchor2_ ? anchor1_ : anchor2_;
+        if (static_cast<size_t>(last - p) >= kLanes + max_anchor) {
+            const uint8_t* const vector_last = last - max_anchor - kLanes;
+            for (; p <= vector_last; p += kLanes) {
+                uint64_t bits = candidateBits(p + anchor1_, p + anchor2_, b1, b2);
+                while (bits) {
+                    size_t lane = static_cast<size_t>(__builtin_ctzll(bits)) / kBitsPerLane;
+                    bits &= ~(kLaneMask << (lane * kBitsPerLane));
+                    if (verify(p + lane) && !on_match(p + lane)) return;
+                }
+            }
+        }
+#endif
+
+        // 标量收尾（或无 SIMD 时）：memchr 跳到下一个锚点字节
+        while (p <= last) {
+            const void* hit = memchr(p + anchor1_, b1, static_cast<size_t>(last - p) + 1);
+            if (!hit) return;
+            const uint8_t* candidate = static_cast<const uint8_t*>(hit) - anchor1_;
+            if (candidate[anchor2_] == b2 && verify(candidate) && !on_match(candidate)) return;
+            p = candidate + 1;
+        }
+    }
+
+private:
+#if FG_SCAN_SIMD
+#if defined(__aarch64__)
+    // NEON：vshrn 把 16 字节比较结果压成 64 位，每字节 4 位
+    static constexpr size_t kLanes = 16;
+    static constexpr size_t kBitsPerLane = 4;
+    static constexpr uint64_t kLaneMask = 0xF;
+
+    static uint64_t candidateBits(const uint8_t* a, const uint8_t* b, uint8_t b1, uint8_t b2) {
+        uint8x16_t eq = vandq_u8(vceqq_u8(vld1q_u8(a), vdupq_n_u8(b1)),
+                                 vceqq_u8(vld1q_u8(b), vdupq_n_u8(b2)));
+        uint8x8_t narrowed = vshrn_n_u16(vreinterpretq_u16_u8(eq), 4);
+        return vget_lane_u64(vreinterpret_u64_u8(narrowed), 0);
+    }
+#elif defined(__AVX2__)
+    static constexpr size_t kLanes = 32;
+    static constexpr size_t kBitsPerLane = 1;
+    static constexpr uint64_t kLaneMask = 0x1;
+
+    static uint64_t candidateBits(const uint8_t* a, const uint8_t* b, uint8_t b1, uint8_t b2) {
+        __m256i eq1 = _mm256_cmpeq_epi8(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(a)),
+                                        _mm256_set1_epi8(static_cast<char>(b1)));
+        __m256i eq2 = _mm256_cmpeq_epi8(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(b)),
+                                        _mm256_set1_epi8(static_cast<char>(b2)));
+        return static_cast<uint32_t>(_mm256_movemask_epi8(_mm256_and_si256(eq1, eq2)));
+    }
+#else
+    static constexpr size_t kLanes = 16;
+    static constexpr size_t kBitsPerLane = 1;
+    static constexpr uint64_t kLaneMask = 0x1;
+
+    static uint64_t candidateBits(const uint8_t* a, const uint8_t* b, uint8_t b1, uint8_t b2) {
+        __m128i eq1 = _mm_cmpeq_epi8(_mm_loadu_si128(reinterpret_cast<const __m128i*>(a)),
+                                     _mm_set1_epi8(static_cast<char>(b1)));
+        __m128i eq2 = _mm_cmpeq_epi8(_mm_loadu_si128(reinterpret_cast<const __m128i*>(b)),
+                                     _mm_set1_epi8(static_cast<char>(b2)));
+        return static_cast<uint32_t>(_mm_movemask_epi8(_mm_and_si128(eq1, eq2)));
+    }
+#endif
+#endif
+
+    static int hexValue(char c) {
+        if (c >= '0' && c <= '9') return c - '0';
+        if (c >= 'a' && c <= 'f') return c - 'a' + 10;
+        if (c >= 'A' && c <= 'F') return c - 'A' + 10;
+        return -1;
+    }
+
+    // 解析以空格分隔的两位十六进制记号，'?' 表示对应半字节通配
+    static bool parseTokens(std::string_view text, std::vector<uint8_t>& bytes, std::vector<uint8_t>& mask) {
+        size_t i = 0;
+        while (i < text.size()) {
+            if (text[i] == ' ') { ++i; continue; }
+            if (i + 1 >= text.size()) return false;
+
+            uint8_t value = 0, nibble_mask = 0;
+            for (int k = 0; k < 2; ++k) {
+                char c = text[i + k];
+                value <<= 4;
+                nibble_mask <<= 4;
+                if (c != '?') {
+                    int v = hexValue(c);
+                    if (v < 0) return false;
+                    value |= v;
+                    nibble_mask |= 0xF;
+                }
+            }
+            bytes.push_back(value);
+            mask.push_back(nibble_mask);
+            i += 2;
+        }
+        return true;
+    }
+
+    // 0x00 / 0xFF 等在代码段中极常见，尽量避开；第二锚点取离第一锚点最远的完整字节
+    void chooseAnchors() {
+        auto commonness = [](uint8_t b) {
+            if (b == 0x00 || b == 0xFF) return 3;
+            if (b < 0x10 || b > 0xF0) return 2;
+            return 1;
+        };
+
+        has_anchor_ = false;
+        for (size_t i = 0; i < bytes_.size(); ++i) {
+            if (mask_[i] != 0xFF) continue;
+            if (!has_anchor_ || commonness(bytes_[i]) < commonness(bytes_[anchor1_])) {
+                anchor1_ = i;
+                has_anchor_ = true;
+            }
+        }
+        if (!has_anchor_) return;
+
+        anchor2_ = anchor1_;
+        size_t best_distance = 0;
+        for (size_t i = 0; i < bytes_.size(); ++i) {
+            if (mask_[i] != 0xFF) continue;
+            size_t distance = i > anchor1_ ? i - anchor1_ : anchor1_ - i;
+            if (distance > best_distance) {
+                best_distance = distance;
+                anchor2_ = i;
+            }
+        }
+    }
+
+    bool verify(const uint8_t* p) const {
+        for (size_t i = 0; i < bytes_.size(); ++i) {
+            if ((p[i] & mask_[i]) != bytes_[i]) return false;
+        }
+        return true;
+    }
+
+    std::vector<uint8_t> bytes_;
+    std::vector<uint8_t> mask_;
+    size_t anchor1_ = 0;
+    size_t anchor2_ = 0;
+    bool has_anchor_ = false;
+};
+
+// ============================
+// 工作线程池
+// ============================
+
+// 固定线程数的小型线程池，任务按提交顺序执行
+class WorkerPool {
+public:
+    // 全局共享池：线程数 = min(CPU 核数, 4)
+    static WorkerPool& shared() {
+        static WorkerPool pool(std::clamp<unsigned>(std::thread::hardware_concurrency(), 1u, 4u));
+        return pool;
+    }
+
+    explicit WorkerPool(size_t thread_count) {
+        for (size_t i = 0; i < thread_count; ++i) {
+            threads_.emplace_back([this] { run(); });
+        }
+    }
+
+    ~WorkerPool() {
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            stopping_ = true;
+        }
+        cv_.notify_all();
+        for (std::thread& thread : threads_) {
+            thread.join();
+        }
+    }
+
+    WorkerPool(const WorkerPool&) = delete;
+    WorkerPool& operator=(const WorkerPool&) = delete;
+
+    size_t size() const { return threads_.size(); }
+
+    void submit(std::function<void()> task) {
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            tasks_.push_back(std::move(task));
+        }
+        cv_.notify_one();
+    }
+
+private:
+    void run() {
+        for (;;) {
+            std::function<void()> task;
+            {
+                std::unique_lock<std::mutex> lock(mutex_);
+                cv_.wait(lock, [this] { return stopping_ || !tasks_.empty(); });
+                if (tasks_.empty()) return;
+                task = std::move(tasks_.front());
+                tasks_.pop_front();
+            }
+            task();
+        }
+    }
+
+    std::mutex mutex_;
+    std::condition_variable cv_;
+    std::deque<std::function<void()>> tasks_;
+    std::vector<std::thread> threads_;
+    bool stopping_ = false;
+};
+
+// ============================
+// 并行区域扫描
+// ============================
+
+enum class ScanMode {
+    ALL,           // 返回全部匹配（按地址升序）
+    FIRST_LOWEST,  // 只要地址最低的匹配，确认后其余工作线程提前退出
+};
+
+// 把 [begin, end) 切成页对齐的块分发给共享线程池，相邻块重叠 pattern.size()-1 字节，
+// 匹配只归属于其起点所在的块，因此不会重复也不会遗漏。
+// 调用线程同样参与领取块：即使线程池全忙也能独立完成，不会因等待线程池而死锁
+inline std::vector<const uint8_t*> parallelScan(const BytePattern& pattern,
+                                                const uint8_t* begin, const uint8_t* end,
+                                                ScanMode mode) {
+    constexpr uintptr_t kPageSize = 4096;
+    constexpr size_t kMinChunkSize = 256 * 1024;
+
+    struct ScanState {
+        const BytePattern* pattern;
+        uintptr_t begin, end, chunk_size;
+        size_t chunk_count;
+        ScanMode mode;
+        std::atomic<size_t> next_chunk{0};
+        std::atomic<uintptr_t> lowest_match{UINTPTR_MAX};
+        std::mutex mutex;
+        std::condition_variable idle_cv;
+        size_t in_progress = 0;          // 已领取但未完成的块（mutex 保护）
+        std::vector<const uint8_t*> matches;
+    };
+
+    std::vector<const uint8_t*> empty;
+    if (end <= begin || static_cast<size_t>(end - begin) < pattern.size()) {
+        return empty;
+    }
+
+    WorkerPool& pool = WorkerPool::shared();
+    const size_t total = end - begin;
+    size_t chunk_size = std::max(kMinChunkSize, total / (pool.size() * 8 + 1));
+    chunk_size = (chunk_size + kPageSize - 1) & ~(kPageSize - 1);
+
+    // 块边界按绝对地址页对齐
+    const uintptr_t first_boundary = (reinterpret_cast<uintptr_t>(begin) + chunk_size) & ~(kPageSize - 1);
+    const uintptr_t aligned_origin = first_boundary - chunk_size;
+
+    auto state = std::make_shared<ScanState>();
+    state->pattern = &pattern;
+    state->begin = reinterpret_cast<uintptr_t>(begin);
+    state->end = reinterpret_cast<uintptr_t>(end);
+    state->chunk_size = chunk_size;
+    state->chunk_count = (state->end - aligned_origin + chunk_size - 1) / chunk_size;
+    state->mode = mode;
+
+    // 领取并扫描块，直到没有剩余；未领取到块的线程不会触碰 pattern
+    auto worker = [state, aligned_origin]() {
+        for (;;) {
+            {
+                std::lock_guard<std::mutex> lock(state->mutex);
+                ++state->in_progress;
+            }
+            size_t index = state->next_chunk.fetch_add(1);
+            bool claimed = index < state->chunk_count;
+
+            if (claimed) {
+                uintptr_t chunk_start = std::max(state->begin, aligned_origin + index * state->chunk_size);
+                uintptr_t chunk_end = std::min(state->end, aligned_origin + (index + 1) * state->chunk_size);
+                // 更低地址已有匹配时，后面的块无需扫描
+                if (state->mode != ScanMode::FIRST_LOWEST || chunk_start < state->lowest_match.load()) {
+                    uintptr_t scan_end = std::min(state->end, chunk_end + state->pattern->size() - 1);
+                    std::vector<const uint8_t*> local;
+                    state->pattern->scan(reinterpret_cast<const uint8_t*>(chunk_start),
+                                         reinterpret_cast<const uint8_t*>(scan_end),
+                        [&](const uint8_t* match) {
+                            auto address = reinterpret_cast<uintptr_t>(match);
+                            if (address >= chunk_end) return false;  // 属于下一块
+                            if (state->mode == ScanMode::FIRST_LOWEST) {
+                                uintptr_t current = state->lowest_match.load();
+                                while (address < current &&
+                                       !state->lowest_match.compare_exchange_weak(current, address)) {
+                                }
+                                return false;  // 块内后续匹配地址更高
+                            }
+                            local.push_back(match);
+                            return true;
+                        });
+                    if (!local.empty()) {
+                        std::lock_guard<std::mutex> lock(state->mutex);
+                        state->matches.insert(state->matches.end(), local.begin(), local.end());
+                    }
+                }
+            }
+
+            {
+                std::lock_guard<std::mutex> lock(state->mutex);
+                if (--state->in_progress == 0) state->idle_cv.notify_all();
+            }
+            if (!claimed) return;
+        }
+    };
+
+    size_t helpers = std::min(pool.size(), state->chunk_count > 0 ? state->chunk_count - 1 : 0);
+    for (size_t i = 0; i < helpers; ++i) {
+        pool.submit(worker);
+    }
+    worker();
+
+    // 所有块都已领取；等待仍在扫描的块完成后结果才算确认
+    std::unique_lock<std::mutex> lock(state->mutex);
+    state->idle_cv.wait(lock, [&state] { return state->in_progress == 0; });
+
+    if (mode == ScanMode::FIRST_LOWEST) {
+        uintptr_t lowest = state->lowest_match.load();
+        if (lowest == UINTPTR_MAX) return empty;
+        return {reinterpret_cast<const uint8_t*>(lowest)};
+    }
+
+    std::sort(state->matches.begin(), state->matches.end());
+    return std::move(state->matches);
+}
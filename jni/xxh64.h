@@ -0,0 +1,54 @@
+// XXH64（与 xxHash 参考实现结果一致），用于 maps 内容比较与 Lua chunk 去重
+// 设备端（jni/main.cpp）与主机端工具共用，只依赖标准库
+
+#pragma once
+
+#include <cstdint>
+#include <cstddef>
+#include <cstring>
+
+inline uint64_t xxh64Read64(const uint8_t* p) { uint64_t v; memcpy(&v, p, sizeof(v)); return v; }
+inline uint32_t xxh64Read32(const uint8_t* p) { uint32_t v; memcpy(&v, p, sizeof(v)); return v; }
+static inline uint64_t xxh64Rotl(uint64_t x, int r) { return (x << r) | (x >> (64 - r)); }
+
+inline uint64_t xxh64(const void* data, size_t size, uint64_t seed = 0) {
+    constexpr uint64_t P1 = 0x9E3779B185EBCA87ULL, P2 = 0xC2B2AE3D27D4EB4FULL, P3 = 0x165667B19E3779F9ULL,
+                       P4 = 0x85EBCA77C2B2AE63ULL, P5 = 0x27D4EB2F165667C5ULL;
+    auto round = [](uint64_t acc, uint64_t input) { return xxh64Rotl(acc + input * P2, 31) * P1; };
+    auto merge = [&](uint64_t acc, uint64_t val) { return (acc ^ round(0, val)) * P1 + P4; };
+    
+    const uint8_t* p = static_cast<const uint8_t*>(data);
+    const uint8_t* end = p + size;
+    uint64_t h;
+    if (size >= 32) {
+        uint64_t v1 = seed + P1 + P2, v2 = seed + P2, v3 = seed, v4 = seed - P1;
+        for (const uint8_t* limit = end - 32; p <= limit; p += 32) {
+            v1 = round(v1, xxh64Read64(p));
+            v2 = round(v2, xxh64Read64(p + 8));
+            v3 = round(v3, xxh64Read64(p + 16));
+            v4 = round(v4, xxh64Read64(p + 24));
+        }
+        h = xxh64Rotl(v1, 1) + xxh64Rotl(v2, 7) + xxh64Rotl(v3, 12) + xxh64Rotl(v4, 18);
+        h = merge(merge(merge(merge(h, v1), v2), v3), v4);
+    } else {
+        h = seed + P5;
+    }
+    h += size;
+    
+    for (; p + 8 <= end; p += 8) {
+        h = xxh64Rotl(h ^ round(0, xxh64Read64(p)), 27) * P1 + P4;
+    }
+    if (p + 4 <= end) {
+        h = xxh64Rotl(h ^ (uint64_t(xxh64Read32(p)) * P1), 23) * P2 + P3;
+        p += 4;
+    }
+    for (; p < end; p++) {
+        h = xxh64Rotl(h ^ (*p * P5), 11) * P1;
+    }
+    h ^= h >> 33;
+    h *= P2;
+    h ^= h >> 29;
+    h *= P3;
+    h ^= h >> 32;
+    return h;
+}
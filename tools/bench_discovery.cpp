@@ -0,0 +1,168 @@
+// 启动发现阶段基准：在 maps 中等待并查找 base.apk，比较 maps 快照 + 字面匹配（jni/maps_snapshot.h）
+// 与旧的 ifstream + std::regex 重试循环
+//
+// 编译: g++ -std=c++17 -O2 -I jni tools/bench_discovery.cpp -o bench_discovery
+// 用法: ./bench_maps gen 10000 maps_10k.txt          生成夹具（或用真机抓取的 maps）
+//       ./bench_discovery <maps文件> <包名> [重试次数]
+// 前 <重试次数>（默认 100）次读取看到的是去掉 base.apk 行的夹具，之后换成完整夹具，
+// 模拟冷启动时 base.apk 晚于本库出现在 maps 中。两边都不计 usleep 与包名解析。
+
+#include <cstdio>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <chrono>
+#include <regex>
+#include <string>
+#include <string_view>
+#include <utility>
+
+#include "maps_snapshot.h"
+#include "legacy_maps.h"
+
+// 两份夹具：base.apk 映射出现之前与之后
+struct Fixture {
+    std::string before_path;
+    std::string after_path;
+    int appear_after = 100;
+
+    const char* pathFor(int attempt) const {
+        return attempt < appear_after ? before_path.c_str() : after_path.c_str();
+    }
+};
+
+// ============================
+// 旧实现（优化前 jni/main.cpp 的 findBaseApkPath / workerThread 步骤 3，去掉日志与计时；parseMaps 见 legacy_maps.h）
+// ============================
+
+static std::string legacyFindBaseApkPath(const LibraryMap& library_map, const std::string& package_name) {
+    if (package_name.empty()) return "";
+    std::string pattern_str = ".*" + package_name + ".*base\\.apk";
+    std::regex apk_pattern(pattern_str);
+    for (const auto& [lib_name, lib_path] : library_map) {
+        std::smatch match;
+        if (std::regex_search(lib_path, match, apk_pattern)) {
+            size_t apk_pos = lib_path.find("base.apk");
+            if (apk_pos != std::string::npos) {
+                return lib_path.substr(0, apk_pos + std::strlen("base.apk"));
+            }
+        }
+    }
+    return "";
+}
+
+static std::string legacyDiscover(const Fixture& fixture, const std::string& package_name, int* attempts) {
+    int attempt = 0;
+    LibraryMap library_map = legacyParseMaps(fixture.pathFor(attempt++));
+    std::string base_apk_path;
+    while (base_apk_path.empty() && attempt < 0xfffff) {
+        base_apk_path = legacyFindBaseApkPath(library_map, package_name);
+        if (base_apk_path.empty()) {
+            library_map = legacyParseMaps(fixture.pathFor(attempt++));
+        }
+    }
+    *attempts = attempt;
+    return base_apk_path;
+}
+
+// ============================
+// 新实现（jni/main.cpp 步骤 3：两份快照交替读取，只检查新增/变化的映射）
+// ============================
+
+static std::string snapshotDiscover(const Fixture& fixture, std::string_view package_name, int* attempts) {
+    MapsSnapshot previous, current;
+    std::string base_apk_path;
+    int attempt = 0;
+    while (attempt < 0xfffff) {
+        if (current.read(fixture.pathFor(attempt++))) {
+            current.diff(previous, [&](const MapsEvent& event) {
+                if (event.change != MapsChange::REMOVED && base_apk_path.empty() &&
+                    isBaseApkOf(event.after->path, package_name)) {
+                    base_apk_path.assign(event.after->path);
+                }
+            });
+            std::swap(previous, current);
+        }
+        if (!base_apk_path.empty()) break;
+    }
+    *attempts = attempt;
+    return base_apk_path;
+}
+
+// ============================
+// 计时
+// ============================
+
+template <typename Fn>
+static double microseconds(int rounds, Fn&& fn) {
+    fn();  // 预热页缓存
+    auto begin = std::chrono::steady_clock::now();
+    for (int i = 0; i < rounds; i++) fn();
+    auto elapsed = std::chrono::steady_clock::now() - begin;
+    return double(std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed).count()) / 1000.0 / rounds;
+}
+
+int main(int argc, char** argv) {
+    if (argc != 3 && argc != 4) {
+        fprintf(stderr, "用法: %s <maps文件> <包名> [重试次数]\n", argv[0]);
+        return 2;
+    }
+    std::string package_name = argv[2];
+
+    // 去掉该包 base.apk 的所有映射，得到"出现之前"的夹具
+    MapsSnapshot full;
+    if (!full.read(argv[1])) {
+        perror(argv[1]);
+        return 1;
+    }
+    std::string before;
+    size_t removed = 0;
+    for (std::string_view rest = full.raw(); !rest.empty();) {
+        size_t eol = rest.find('\n');
+        std::string_view line = rest.substr(0, eol == std::string_view::npos ? rest.size() : eol + 1);
+        rest.remove_prefix(line.size());
+        std::string_view body = line.back() == '\n' ? line.substr(0, line.size() - 1) : line;
+        size_t path_start = body.find('/');
+        if (path_start != std::string_view::npos && isBaseApkOf(body.substr(path_start), package_name)) {
+            removed++;
+            continue;
+        }
+        before.append(line);
+    }
+    if (removed == 0) {
+        fprintf(stderr, "夹具中没有 %s 的 base.apk 映射\n", package_name.c_str());
+        return 1;
+    }
+
+    Fixture fixture;
+    fixture.before_path = std::string(argv[1]) + ".before";
+    fixture.after_path = argv[1];
+    fixture.appear_after = argc == 4 ? atoi(argv[3]) : 100;
+    if (!writeFile(fixture.before_path, before)) return 1;
+
+    int legacy_attempts = 0, snapshot_attempts = 0;
+    std::string legacy_apk = legacyDiscover(fixture, package_name, &legacy_attempts);
+    std::string snapshot_apk = snapshotDiscover(fixture, package_name, &snapshot_attempts);
+    if (legacy_apk != snapshot_apk) {
+        fprintf(stderr, "结果不一致:\n  regex:    %s\n  snapshot: %s\n", legacy_apk.c_str(), snapshot_apk.c_str());
+        remove(fixture.before_path.c_str());
+        return 1;
+    }
+
+    size_t lines = 0;
+    for (char c : full.raw()) lines += c == '\n';
+    int rounds = fixture.appear_after > 1000 ? 3 : 20;
+    int attempts = 0;
+    double legacy = microseconds(rounds, [&] { legacyDiscover(fixture, package_name, &attempts); });
+    double snapshot = microseconds(rounds, [&] { snapshotDiscover(fixture, package_name, &attempts); });
+    remove(fixture.before_path.c_str());
+
+    printf("%s: %zu 行，去掉 %zu 条 base.apk 映射，第 %d 次读取后出现\n", argv[1], lines, removed,
+           fixture.appear_after);
+    printf("  base.apk: %s\n", snapshot_apk.c_str());
+    printf("  ifstream + regex  %10.1f us  （%d 次读取，%.1f us/次）\n", legacy, legacy_attempts,
+           legacy / legacy_attempts);
+    printf("  快照 + 字面匹配   %10.1f us  （%d 次读取，%.1f us/次）  %.1fx\n", snapshot, snapshot_attempts,
+           snapshot / snapshot_attempts, legacy / snapshot);
+    return 0;
+}
@@ -0,0 +1,177 @@
+// 库目录扫描基准：比较 opendir + fstatat 扫描（jni/library_scan.h）与旧的 popen("ls -l | grep") + std::regex
+//
+// 编译: g++ -std=c++17 -O2 -I jni tools/bench_libscan.cpp -o bench_libscan
+// 用法: ./bench_libscan [目录] [库数量]
+// 目录默认 /tmp/fg_libscan，其中生成 <库数量>（默认 200）个带节区头表的 ELF64 .so（稀疏文件，大小各不相同）。
+// Android 的 toybox ls 输出 ISO 日期，主机上的 GNU ls 需要 --time-style=long-iso 才能被旧正则匹配。
+
+#include <cerrno>
+#include <cstdio>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <chrono>
+#include <regex>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include <sys/stat.h>
+
+#include "library_scan.h"
+
+// ============================
+// 夹具生成
+// ============================
+
+// 写出一个最小的 ELF64：文件头 + 节区头表（每 3 个库中有一个不含 .dynsym），再用 ftruncate 撑到目标大小
+static bool writeFixtureLibrary(const std::string& path, size_t index, off_t size) {
+    constexpr int kSections = 8;
+    Elf64_Ehdr ehdr = {};
+    memcpy(ehdr.e_ident, ELFMAG, SELFMAG);
+    ehdr.e_ident[EI_CLASS] = ELFCLASS64;
+    ehdr.e_ident[EI_DATA] = ELFDATA2LSB;
+    ehdr.e_ident[EI_VERSION] = EV_CURRENT;
+    ehdr.e_type = ET_DYN;
+    ehdr.e_machine = EM_AARCH64;
+    ehdr.e_version = EV_CURRENT;
+    ehdr.e_ehsize = sizeof(Elf64_Ehdr);
+    ehdr.e_shoff = sizeof(Elf64_Ehdr);
+    ehdr.e_shentsize = sizeof(Elf64_Shdr);
+    ehdr.e_shnum = kSections;
+
+    Elf64_Shdr sections[kSections] = {};
+    for (int i = 1; i < kSections; i++) sections[i].sh_type = SHT_PROGBITS;
+    if (index % 3 != 0) sections[2].sh_type = SHT_DYNSYM;
+
+    int fd = open(path.c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+    if (fd < 0) {
+        perror(path.c_str());
+        return false;
+    }
+    bool ok = write(fd, &ehdr, sizeof(ehdr)) == ssize_t(sizeof(ehdr)) &&
+              write(fd, sections, sizeof(sections)) == ssize_t(sizeof(sections)) && ftruncate(fd, size) == 0;
+    close(fd);
+    return ok;
+}
+
+static bool createFixture(const std::string& dir, size_t count) {
+    if (mkdir(dir.c_str(), 0755) != 0 && errno != EEXIST) {
+        perror(dir.c_str());
+        return false;
+    }
+    for (size_t i = 0; i < count; i++) {
+        char name[64];
+        snprintf(name, sizeof(name), "/libfixture%03zu.so", i);
+        // 大小互不相同，最大的是最后一个
+        off_t size = off_t(64 * 1024 + i * 37 * 1024);
+        if (!writeFixtureLibrary(dir + name, i, size)) return false;
+    }
+    return true;
+}
+
+// ============================
+// 旧实现（优化前 jni/main.cpp 的 executeCommand / findLargestLibrary，去掉日志与计时）
+// ============================
+
+static std::string executeCommand(const std::string& cmd) {
+    FILE* pipe = popen(cmd.c_str(), "r");
+    if (!pipe) {
+        return "";
+    }
+    std::stringstream result;
+    char buffer[256];
+    while (fgets(buffer, sizeof(buffer), pipe) != nullptr) {
+        result << buffer;
+    }
+    pclose(pipe);
+    return result.str();
+}
+
+static std::vector<LibraryInfo> legacyListLibraries(const std::string& lib_dir) {
+    std::vector<LibraryInfo> libraries;
+    std::string cmd = "ls -l --time-style=long-iso " + lib_dir + " | grep -v ^total";
+    std::string output = executeCommand(cmd);
+    std::istringstream stream(output);
+    std::string line;
+    std::regex pattern(R"(\s+(\d+)\s+\d{4}-\d{2}-\d{2}\s+\d{2}:\d{2}\s+(\S+\.so))");
+    while (std::getline(stream, line)) {
+        if (line.empty() || line.find_first_not_of(" \t\r\n") == std::string::npos) {
+            continue;
+        }
+        std::smatch match;
+        if (std::regex_search(line, match, pattern)) {
+            std::string size_str = match[1].str();
+            std::string filename = match[2].str();
+            char* endptr = nullptr;
+            unsigned long long size = strtoull(size_str.c_str(), &endptr, 10);
+            if (endptr != size_str.c_str() && *endptr == '\0') {
+                libraries.push_back({filename, static_cast<size_t>(size)});
+            }
+        }
+    }
+    return libraries;
+}
+
+static const LibraryInfo* largest(const std::vector<LibraryInfo>& libraries) {
+    auto it = std::max_element(libraries.begin(), libraries.end(),
+                               [](const LibraryInfo& a, const LibraryInfo& b) { return a.size < b.size; });
+    return it == libraries.end() ? nullptr : &*it;
+}
+
+// ============================
+// 计时
+// ============================
+
+template <typename Fn>
+static double microseconds(int rounds, Fn&& fn) {
+    fn();  // 预热目录项与 inode 缓存
+    auto begin = std::chrono::steady_clock::now();
+    for (int i = 0; i < rounds; i++) fn();
+    auto elapsed = std::chrono::steady_clock::now() - begin;
+    return double(std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed).count()) / 1000.0 / rounds;
+}
+
+int main(int argc, char** argv) {
+    if (argc > 3 || (argc > 1 && argv[1][0] == '-')) {
+        fprintf(stderr, "用法: %s [目录] [库数量]\n", argv[0]);
+        return 2;
+    }
+    std::string dir = argc > 1 ? argv[1] : "/tmp/fg_libscan";
+    size_t count = argc > 2 ? strtoull(argv[2], nullptr, 10) : 200;
+    if (!createFixture(dir, count)) return 1;
+
+    std::vector<LibraryInfo> legacy = legacyListLibraries(dir);
+    std::vector<LibraryInfo> scanned;
+    if (!scanLibraryDirectory(dir, &scanned)) {
+        perror(dir.c_str());
+        return 1;
+    }
+    const LibraryInfo* legacy_largest = largest(legacy);
+    const LibraryInfo* scanned_largest = largest(scanned);
+    if (legacy.size() != scanned.size() || !legacy_largest || !scanned_largest ||
+        legacy_largest->name != scanned_largest->name) {
+        fprintf(stderr, "结果不一致: ls %zu 个库（最大 %s），扫描 %zu 个库（最大 %s）\n", legacy.size(),
+                legacy_largest ? legacy_largest->name.c_str() : "-", scanned.size(),
+                scanned_largest ? scanned_largest->name.c_str() : "-");
+        return 1;
+    }
+    LibraryInfo target = *scanned_largest;  // scanned 在计时中会被重新填充
+    size_t with_dynsym = std::count_if(scanned.begin(), scanned.end(), [](const LibraryInfo& lib) {
+        return lib.e_machine == EM_AARCH64 && lib.has_dynsym;
+    });
+
+    constexpr int kRounds = 50;
+    size_t sink = 0;
+    double popen_us = microseconds(kRounds, [&] { sink += legacyListLibraries(dir).size(); });
+    double scan_us = microseconds(kRounds, [&] {
+        scanLibraryDirectory(dir, &scanned);
+        sink += scanned.size();
+    });
+
+    printf("%s: %zu 个库，最大 %s（%zu 字节），%zu 个含 .dynsym\n", dir.c_str(), scanned.size(),
+           target.name.c_str(), target.size, with_dynsym);
+    printf("  popen(ls -l) + regex      %10.1f us\n", popen_us);
+    printf("  opendir + fstatat + ELF   %10.1f us  %.1fx\n", scan_us, popen_us / scan_us);
+    return sink != 0 ? 0 : 1;
+}
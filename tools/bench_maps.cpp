@@ -0,0 +1,233 @@
+// maps 解析基准：比较 MapsSnapshot（jni/maps_snapshot.h）与旧的 ifstream + getline 实现的每行耗时
+//
+// 编译: g++ -std=c++17 -O2 -I jni tools/bench_maps.cpp -o bench_maps
+// 用法: ./bench_maps gen <行数> <输出文件>    生成 Android 风格的 maps 夹具（固定种子，结果可复现）
+//       ./bench_maps <maps文件>...            对每个文件分别计时
+//       ./bench_maps                          生成 2k/10k/50k 行夹具到 /tmp 后计时
+// 真机抓取: adb shell cat /proc/<pid>/maps > maps.txt
+
+#include <cstdio>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <algorithm>
+#include <chrono>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "maps_snapshot.h"
+#include "legacy_maps.h"
+
+// ============================
+// 夹具生成
+// ============================
+
+// 小型线性同余生成器，夹具内容只取决于行数
+struct FixtureRandom {
+    uint64_t state = 0x9E3779B97F4A7C15ull;
+    uint32_t next() {
+        state = state * 6364136223846793005ull + 1442695040888963407ull;
+        return uint32_t(state >> 33);
+    }
+    uint32_t below(uint32_t n) { return next() % n; }
+};
+
+static void appendLine(std::string* out, uint64_t start, uint64_t end, const char* perms, uint64_t offset,
+                       const char* dev, uint64_t inode, std::string_view path) {
+    char line[160];
+    int n = snprintf(line, sizeof(line), "%012llx-%012llx %s %08llx %s %llu", (unsigned long long)start,
+                     (unsigned long long)end, perms, (unsigned long long)offset, dev, (unsigned long long)inode);
+    out->append(line, size_t(n));
+    if (!path.empty()) {
+        // 内核把路径列对齐到第 74 列（64 位地址时更靠后），这里按同样方式补空格
+        out->append(size_t(n) < 73 ? 73 - size_t(n) : 1, ' ');
+        out->append(path);
+    }
+    out->push_back('\n');
+}
+
+// 按真机 maps 的大致构成生成：系统库与应用库各 4 段（r--p/r-xp/r--p/rw-p）、base.apk 映射、
+// dalvik/scudo 等命名匿名映射与普通匿名映射
+static std::string generateFixture(size_t lines) {
+    static const char* const kSystemLibs[] = {"libc.so", "libm.so", "libdl.so", "liblog.so", "libutils.so",
+                                              "libbinder.so", "libandroid_runtime.so", "libhwui.so", "libEGL.so",
+                                              "libGLESv2.so", "libvulkan.so", "libsqlite.so", "libssl.so",
+                                              "libcrypto.so", "libz.so", "libc++.so", "libicuuc.so", "libart.so"};
+    static const char* const kAppLibs[] = {"libcocos2dcpp.so", "libcpp_shared.so", "libluajapi.so",
+                                           "libil2cpp.so", "libunity.so", "libmain.so", "libgame.so"};
+    static const char* const kAnonNames[] = {"[anon:dalvik-main space (region space)]",
+                                             "[anon:dalvik-LinearAlloc]", "[anon:scudo:primary]",
+                                             "[anon:scudo:secondary]", "[anon:libc_malloc]",
+                                             "[anon:stack_and_tls:1234]", "[anon:.bss]", "/dev/ashmem/dalvik-jit-code-cache (deleted)",
+                                             "/dev/kgsl-3d0", "[anon:dalvik-/system/framework/boot.art]"};
+    constexpr std::string_view kAppDir = "/data/app/~~Zm9vYmFyYmF6cXV4==/com.example.game-cXV4cXV4Zm9v==/";
+
+    FixtureRandom random;
+    std::string out;
+    out.reserve(lines * 110);
+    uint64_t address = 0x12c00000;
+    uint64_t inode = 1000;
+    size_t written = 0;
+    auto emit = [&](uint64_t size, const char* perms, uint64_t offset, const char* dev, uint64_t node,
+                    std::string_view path) {
+        appendLine(&out, address, address + size, perms, offset, dev, node, path);
+        address += size;
+        written++;
+    };
+
+    std::string path;
+    while (written < lines) {
+        uint32_t kind = random.below(10);
+        uint64_t pages = 1 + random.below(64);
+        if (kind < 3) {
+            // 系统库：/system/lib64/<名称>，同一文件的 4 段连续映射
+            const char* name = kSystemLibs[random.below(sizeof(kSystemLibs) / sizeof(kSystemLibs[0]))];
+            path = std::string("/system/lib64/") + name;
+            uint64_t node = inode++;
+            emit(pages * 0x1000, "r--p", 0, "fd:00", node, path);
+            emit(pages * 0x2000, "r-xp", pages * 0x1000, "fd:00", node, path);
+            emit(0x1000, "r--p", pages * 0x3000, "fd:00", node, path);
+            emit(0x1000, "rw-p", pages * 0x3000 + 0x1000, "fd:00", node, path);
+        } else if (kind < 5) {
+            // 应用库：/data/app/.../lib/arm64/<名称>，或直接从 base.apk 映射
+            uint64_t node = inode++;
+            if (random.below(4) == 0) {
+                path.assign(kAppDir).append("base.apk");
+                uint64_t offset = uint64_t(random.below(4096)) * 0x1000;
+                emit(pages * 0x1000, "r--p", offset, "fd:1c", node, path);
+                emit(pages * 0x2000, "r-xp", offset + pages * 0x1000, "fd:1c", node, path);
+            } else {
+                const char* name = kAppLibs[random.below(sizeof(kAppLibs) / sizeof(kAppLibs[0]))];
+                path.assign(kAppDir).append("lib/arm64/").append(name);
+                emit(pages * 0x1000, "r--p", 0, "fd:1c", node, path);
+                emit(pages * 0x4000, "r-xp", pages * 0x1000, "fd:1c", node, path);
+                emit(0x2000, "rw-p", pages * 0x5000, "fd:1c", node, path);
+            }
+        } else if (kind < 8) {
+            const char* name = kAnonNames[random.below(sizeof(kAnonNames) / sizeof(kAnonNames[0]))];
+            emit(pages * 0x1000, random.below(2) ? "rw-p" : "---p", 0, "00:00", 0, name);
+        } else {
+            emit(pages * 0x1000, "rw-p", 0, "00:00", 0, "");
+        }
+        // 映射之间留出空洞
+        address += uint64_t(random.below(16)) * 0x1000;
+    }
+    // 多写的段截掉，加上末尾的 [stack] 正好 lines 行
+    size_t end = 0;
+    for (size_t i = 0; i + 1 < lines; i++) end = out.find('\n', end) + 1;
+    out.resize(end);
+    out.append("7ffc1a2b3000-7ffc1a2d4000 rw-p 00000000 00:00 0                          [stack]\n");
+    return out;
+}
+
+// ============================
+// 新实现（旧实现 legacyParseMaps 见 legacy_maps.h）
+// ============================
+
+// 新实现下同样的筛选：只为保留的库分配字符串
+static size_t snapshotLibraries(const MapsSnapshot& snapshot) {
+    size_t libraries = 0;
+    for (const MapRecord& rec : snapshot.records()) {
+        if (rec.path.find("data/") == std::string_view::npos) continue;
+        std::string_view name = rec.path.substr(rec.path.rfind('/') + 1);
+        if (name.find(".so") != std::string_view::npos || name.find("base.apk") != std::string_view::npos) {
+            libraries++;
+        }
+    }
+    return libraries;
+}
+
+// ============================
+// 计时
+// ============================
+
+// 每个实现累计处理约 500 万行，至少 20 轮
+static size_t roundsFor(size_t lines) {
+    size_t rounds = 5000000 / (lines ? lines : 1);
+    return rounds < 20 ? 20 : rounds;
+}
+
+// 轮数分成 5 批，取最快的一批：单核虚拟机与手机上的调度抖动会把平均值拉高一截
+template <typename Fn>
+static double nsPerLine(size_t lines, size_t rounds, Fn&& fn) {
+    fn();  // 预热页缓存与分配器
+    constexpr size_t kBatches = 5;
+    size_t per_batch = rounds / kBatches ? rounds / kBatches : 1;
+    double best = 1e300;
+    for (size_t batch = 0; batch < kBatches; batch++) {
+        auto begin = std::chrono::steady_clock::now();
+        for (size_t i = 0; i < per_batch; i++) fn();
+        auto elapsed = std::chrono::steady_clock::now() - begin;
+        best = std::min(best, double(std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed).count()) /
+                                  double(per_batch * lines));
+    }
+    return best;
+}
+
+static bool benchFile(const char* path) {
+    MapsSnapshot probe;
+    if (!probe.read(path)) {
+        perror(path);
+        return false;
+    }
+    size_t lines = 0;
+    for (char c : probe.raw()) lines += c == '\n';
+    size_t rounds = roundsFor(lines);
+
+    // 内容不变时 read() 会跳过解析；交替读取只差一个字节的副本，测的是复用缓冲区的完整解析
+    std::string alternate_path = std::string(path) + ".alt";
+    std::string alternate(probe.raw());
+    alternate.back() = alternate.back() == '\n' ? ' ' : '\n';
+    if (!writeFile(alternate_path, alternate)) return false;
+
+    size_t sink = 0;
+    double legacy = nsPerLine(lines, rounds, [&] { sink += legacyParseMaps(path).size(); });
+
+    MapsSnapshot reused;
+    bool flip = false;
+    double snapshot = nsPerLine(lines, rounds, [&] {
+        flip = !flip;
+        reused.read(flip ? path : alternate_path.c_str());
+        sink += snapshotLibraries(reused);
+    });
+    double unchanged = nsPerLine(lines, rounds, [&] {
+        reused.read(path);
+        sink += snapshotLibraries(reused);
+    });
+    double fresh = nsPerLine(lines, rounds, [&] {
+        MapsSnapshot once;
+        once.read(path);
+        sink += once.records().size();
+    });
+    remove(alternate_path.c_str());
+
+    printf("%-28s %7zu 行  ifstream %7.1f ns/行  快照复用 %6.1f ns/行（%4.1fx）  新建快照 %6.1f  内容未变 %5.1f\n",
+           path, lines, legacy, snapshot, legacy / snapshot, fresh, unchanged);
+    return sink != 0;
+}
+
+int main(int argc, char** argv) {
+    if (argc == 4 && strcmp(argv[1], "gen") == 0) {
+        size_t lines = strtoull(argv[2], nullptr, 10);
+        return writeFile(argv[3], generateFixture(lines)) ? 0 : 1;
+    }
+    if (argc >= 2 && argv[1][0] == '-') {
+        fprintf(stderr, "用法: %s [gen <行数> <输出文件> | <maps文件>...]\n", argv[0]);
+        return 2;
+    }
+
+    std::vector<std::string> paths(argv + 1, argv + argc);
+    if (paths.empty()) {
+        for (size_t lines : {2000, 10000, 50000}) {
+            std::string path = "/tmp/maps_" + std::to_string(lines / 1000) + "k.txt";
+            if (!writeFile(path, generateFixture(lines))) return 1;
+            paths.push_back(path);
+        }
+    }
+    bool ok = true;
+    for (const std::string& path : paths) {
+        ok = benchFile(path.c_str()) && ok;
+    }
+    return ok ? 0 : 1;
+}
@@ -0,0 +1,240 @@
+// 字节模式扫描吞吐基准：在 64MB 数据上比较 BytePattern::scan、parallelScan（jni/pattern_scan.h）、
+// 逐字节暴力匹配，以及（可选）gum_memory_scan，输出 GB/s
+//
+// 编译: g++ -std=c++17 -O2 -pthread -I jni tools/bench_scan.cpp -o bench_scan
+// 对比 gum_memory_scan 时链接主机版 frida-gum devkit（frida-gum-devkit-<版本>-linux-x86_64）：
+//       g++ -std=c++17 -O2 -pthread -DFG_BENCH_GUM=1 -I jni -I <devkit> tools/bench_scan.cpp -o bench_scan
+//           -L <devkit> -lfrida-gum -ldl -lresolv
+// 用法: ./bench_scan [MB数]        默认 64
+
+#include <cstdio>
+#include <cstdint>
+#include <cstdlib>
+#include <chrono>
+#include <string>
+#include <vector>
+
+#include "pattern_scan.h"
+
+#if FG_BENCH_GUM
+#include "frida-gum.h"
+#endif
+
+// ============================
+// 测试数据
+// ============================
+
+struct Random {
+    uint64_t state = 0x2545F4914F6CDD1Dull;
+    uint64_t next() {
+        state ^= state << 13;
+        state ^= state >> 7;
+        state ^= state << 17;
+        return state;
+    }
+};
+
+// 均匀随机字节：锚点字节按 1/256 出现，候选最少
+static std::vector<uint8_t> randomBlob(size_t size) {
+    Random random;
+    std::vector<uint8_t> data(size);
+    for (size_t i = 0; i + 8 <= size; i += 8) {
+        uint64_t word = random.next();
+        memcpy(&data[i], &word, sizeof(word));
+    }
+    return data;
+}
+
+// 近似 arm64 代码段：按 4 字节指令生成，ret / nop / 函数序言 / 零填充较多，锚点候选密集
+static std::vector<uint8_t> codeBlob(size_t size) {
+    static const uint32_t kCommon[] = {
+        0xD65F03C0,  // ret
+        0xD503201F,  // nop
+        0xA9BF7BFD,  // stp x29, x30, [sp, #-16]!
+        0x910003FD,  // mov x29, sp
+        0x00000000,
+    };
+    Random random;
+    std::vector<uint8_t> data(size);
+    for (size_t i = 0; i + 4 <= size; i += 4) {
+        uint64_t roll = random.next();
+        uint32_t insn = (roll & 7) < 3 ? kCommon[(roll >> 3) % 5] : uint32_t(roll >> 32);
+        memcpy(&data[i], &insn, sizeof(insn));
+    }
+    return data;
+}
+
+// 在 3/4 处放一个 evalString 兜底模式的真实匹配（FIRST_LOWEST 需要扫到这里才能确认）
+static void plantMatch(std::vector<uint8_t>& data) {
+    static const uint8_t kMatch[] = {0xC0, 0x03, 0x5F, 0xD6, 0x00, 0x12, 0x34, 0x39, 0xC0, 0x03, 0x5F, 0xD6};
+    memcpy(&data[data.size() / 4 * 3], kMatch, sizeof(kMatch));
+}
+
+// ============================
+// 扫描实现
+// ============================
+
+static size_t bruteForceCount(const std::vector<uint8_t>& bytes, const std::vector<uint8_t>& mask,
+                              const uint8_t* begin, const uint8_t* end) {
+    size_t count = 0;
+    for (const uint8_t* p = begin; p + bytes.size() <= end; p++) {
+        size_t i = 0;
+        while (i < bytes.size() && (p[i] & mask[i]) == bytes[i]) i++;
+        count += i == bytes.size();
+    }
+    return count;
+}
+
+#if FG_BENCH_GUM
+static size_t gumCount(const char* text, const uint8_t* begin, size_t size) {
+    GumMatchPattern* pattern = gum_match_pattern_new_from_string(text);
+    if (!pattern) return 0;
+    GumMemoryRange range = {GUM_ADDRESS(begin), size};
+    size_t count = 0;
+    gum_memory_scan(&range, pattern,
+                    [](GumAddress, gsize, gpointer user_data) -> gboolean {
+                        ++*static_cast<size_t*>(user_data);
+                        return TRUE;
+                    },
+                    &count);
+    gum_match_pattern_unref(pattern);
+    return count;
+}
+#endif
+
+// 与 BytePattern 相同的语法，展开成逐字节的值与掩码，供暴力匹配使用
+static void expandPattern(std::string_view text, std::vector<uint8_t>* bytes, std::vector<uint8_t>* mask) {
+    auto hex = [](char c) {
+        return c <= '9' ? c - '0' : (c | 0x20) - 'a' + 10;
+    };
+    size_t colon = text.find(':');
+    std::string_view parts[2] = {text.substr(0, colon),
+                                 colon == std::string_view::npos ? std::string_view() : text.substr(colon + 1)};
+    bytes->clear();
+    mask->clear();
+    for (size_t i = 0; i + 1 < parts[0].size(); i++) {
+        if (parts[0][i] == ' ') continue;
+        uint8_t value = 0, nibbles = 0;
+        for (int k = 0; k < 2; k++) {
+            char c = parts[0][i + k];
+            value = uint8_t(value << 4);
+            nibbles = uint8_t(nibbles << 4);
+            if (c != '?') {
+                value |= uint8_t(hex(c));
+                nibbles |= 0xF;
+            }
+        }
+        bytes->push_back(value);
+        mask->push_back(nibbles);
+        i++;
+    }
+    size_t index = 0;
+    for (size_t i = 0; i + 1 < parts[1].size(); i++) {
+        if (parts[1][i] == ' ') continue;
+        (*mask)[index++] &= uint8_t(hex(parts[1][i]) << 4 | hex(parts[1][i + 1]));
+        i++;
+    }
+    for (size_t i = 0; i < bytes->size(); i++) (*bytes)[i] &= (*mask)[i];
+}
+
+// ============================
+// 计时
+// ============================
+
+// 取 5 次中最快的一次，返回秒数
+template <typename Fn>
+static double bestSeconds(size_t* result, Fn&& fn) {
+    double best = 1e300;
+    for (int i = 0; i < 5; i++) {
+        auto begin = std::chrono::steady_clock::now();
+        *result = fn();
+        auto elapsed = std::chrono::steady_clock::now() - begin;
+        best = std::min(best, std::chrono::duration<double>(elapsed).count());
+    }
+    return best;
+}
+
+template <typename Fn>
+static double gigabytesPerSecond(size_t size, size_t* result, Fn&& fn) {
+    return double(size) / bestSeconds(result, fn) / 1e9;
+}
+
+int main(int argc, char** argv) {
+    size_t megabytes = argc > 1 ? strtoull(argv[1], nullptr, 10) : 64;
+    if (megabytes == 0) {
+        fprintf(stderr, "用法: %s [MB数]\n", argv[0]);
+        return 2;
+    }
+#if FG_BENCH_GUM
+    gum_init_embedded();
+#endif
+
+    const size_t size = megabytes * 1024 * 1024;
+    struct Blob {
+        const char* name;
+        std::vector<uint8_t> data;
+    } blobs[] = {{"随机", randomBlob(size)}, {"类代码", codeBlob(size)}};
+    for (Blob& blob : blobs) plantMatch(blob.data);
+
+    static const char* const kPatterns[] = {
+        "C0 03 5F D6 00 ?? ?? 39 C0 03 5F D6",   // evalString 兜底扫描使用的模式
+        "FD 7B BF A9 FD 03 00 91",               // 函数序言，类代码数据中极常见
+        "1F 20 03 D5 ?? ?? ?? 94 : FF FF FF FF 00 00 00 FC",  // nop + bl，带掩码
+        "3? ?? ?? ?F",                           // 没有完整字节，走逐位置路径
+    };
+
+    printf("%zu MB，SIMD=%d，线程池 %zu 线程\n", megabytes, FG_SCAN_SIMD, WorkerPool::shared().size());
+    bool ok = true;
+    std::vector<uint8_t> bytes, mask;
+    for (const Blob& blob : blobs) {
+        const uint8_t* begin = blob.data.data();
+        const uint8_t* end = begin + blob.data.size();
+        for (const char* text : kPatterns) {
+            std::optional<BytePattern> pattern = BytePattern::compile(text);
+            if (!pattern) {
+                fprintf(stderr, "模式编译失败: %s\n", text);
+                return 1;
+            }
+            expandPattern(text, &bytes, &mask);
+
+            size_t brute = 0, single = 0, all = 0, lowest = 0;
+            double brute_gbps = gigabytesPerSecond(size, &brute, [&] {
+                return bruteForceCount(bytes, mask, begin, end);
+            });
+            double single_gbps = gigabytesPerSecond(size, &single, [&] {
+                size_t count = 0;
+                pattern->scan(begin, end, [&](const uint8_t*) { return ++count, true; });
+                return count;
+            });
+            double all_gbps = gigabytesPerSecond(size, &all, [&] {
+                return parallelScan(*pattern, begin, end, ScanMode::ALL).size();
+            });
+            // 找到最低匹配即提前结束，吞吐量没有意义，只报耗时
+            double lowest_seconds = bestSeconds(&lowest, [&] {
+                std::vector<const uint8_t*> match = parallelScan(*pattern, begin, end, ScanMode::FIRST_LOWEST);
+                return match.empty() ? SIZE_MAX : size_t(match[0] - begin);
+            });
+
+            printf("[%s] %s\n", blob.name, text);
+            printf("  逐字节暴力        %7.2f GB/s  %zu 个匹配\n", brute_gbps, brute);
+            printf("  BytePattern 单线程 %7.2f GB/s  %zu 个匹配\n", single_gbps, single);
+            printf("  parallelScan 全部  %7.2f GB/s  %zu 个匹配\n", all_gbps, all);
+            if (lowest == SIZE_MAX) {
+                printf("  parallelScan 最低  %7.2f ms    无匹配\n", lowest_seconds * 1e3);
+            } else {
+                printf("  parallelScan 最低  %7.2f ms    +0x%zx\n", lowest_seconds * 1e3, lowest);
+            }
+#if FG_BENCH_GUM
+            size_t gum = 0;
+            double gum_gbps = gigabytesPerSecond(size, &gum, [&] { return gumCount(text, begin, size); });
+            printf("  gum_memory_scan    %7.2f GB/s  %zu 个匹配\n", gum_gbps, gum);
+            ok = ok && gum == brute;
+#endif
+            if (single != brute || all != brute) {
+                fprintf(stderr, "  ✗ 匹配数与暴力匹配不一致\n");
+                ok = false;
+            }
+        }
+    }
+    return ok ? 0 : 1;
+}
@@ -0,0 +1,151 @@
+// BytePattern 交叉校验：随机数据与随机模式下，逐字节暴力匹配的结果必须与 BytePattern::scan、
+// parallelScan（ALL / FIRST_LOWEST）完全一致
+//
+// 编译: g++ -std=c++17 -O2 -pthread -I jni tools/check_scan.cpp -o check_scan
+//       （-mavx2 或在 arm64 上编译可分别覆盖 AVX2 / NEON 路径，默认覆盖 SSE2）
+// 用法: ./check_scan [轮数] [种子]        全部一致时退出码为 0
+
+#include <cstdio>
+#include <cstdint>
+#include <cstdlib>
+#include <string>
+#include <vector>
+
+#include "pattern_scan.h"
+
+struct Random {
+    uint64_t state;
+    uint64_t next() {
+        state ^= state << 13;
+        state ^= state >> 7;
+        state ^= state << 17;
+        return state;
+    }
+    size_t below(size_t n) { return size_t(next() % n); }
+};
+
+// 随机模式：取自数据中的一段（保证大多能命中），随机加入 ??、半字节通配与冒号掩码，
+// 偶尔整段都是通配（走无锚点的逐位置路径）
+static std::string randomPattern(Random& random, const std::vector<uint8_t>& data, std::vector<uint8_t>* bytes,
+                                 std::vector<uint8_t>* mask) {
+    static const char kHex[] = "0123456789ABCDEF";
+    size_t length = 1 + random.below(24);
+    size_t source = random.below(data.size() - length);
+    bool all_wild = random.below(20) == 0;
+    bool with_mask = random.below(5) == 0;
+
+    std::string text, mask_text;
+    bytes->assign(length, 0);
+    mask->assign(length, 0xFF);
+    for (size_t i = 0; i < length; i++) {
+        uint8_t value = random.below(8) == 0 ? uint8_t(random.next()) : data[source + i];
+        uint8_t nibbles = 0xFF;
+        size_t roll = random.below(10);
+        if (all_wild || roll == 0) nibbles = 0x00;
+        else if (roll == 1) nibbles = 0xF0;
+        else if (roll == 2) nibbles = 0x0F;
+
+        if (i) text.push_back(' ');
+        text.push_back(nibbles & 0xF0 ? kHex[value >> 4] : '?');
+        text.push_back(nibbles & 0x0F ? kHex[value & 0xF] : '?');
+
+        uint8_t byte_mask = nibbles;
+        if (with_mask) {
+            uint8_t extra = random.below(3) == 0 ? uint8_t(random.next()) : 0xFF;
+            if (i) mask_text.push_back(' ');
+            mask_text.push_back(kHex[extra >> 4]);
+            mask_text.push_back(kHex[extra & 0xF]);
+            byte_mask &= extra;
+        }
+        (*mask)[i] = byte_mask;
+        (*bytes)[i] = value & byte_mask;
+    }
+    if (with_mask) text += " : " + mask_text;
+    return text;
+}
+
+static std::vector<const uint8_t*> bruteForce(const uint8_t* begin, const uint8_t* end,
+                                              const std::vector<uint8_t>& bytes, const std::vector<uint8_t>& mask) {
+    std::vector<const uint8_t*> matches;
+    for (const uint8_t* p = begin; p + bytes.size() <= end; p++) {
+        size_t i = 0;
+        while (i < bytes.size() && (p[i] & mask[i]) == bytes[i]) i++;
+        if (i == bytes.size()) matches.push_back(p);
+    }
+    return matches;
+}
+
+static void report(const char* what, const std::string& pattern, size_t begin, size_t size,
+                   const std::vector<const uint8_t*>& expected, const std::vector<const uint8_t*>& actual,
+                   const uint8_t* base) {
+    fprintf(stderr, "✗ %s 不一致: 模式 \"%s\"，范围 +%zu 长 %zu，暴力 %zu 个，实际 %zu 个\n", what, pattern.c_str(),
+            begin, size, expected.size(), actual.size());
+    for (size_t i = 0; i < expected.size() || i < actual.size(); i++) {
+        long e = i < expected.size() ? long(expected[i] - base) : -1;
+        long a = i < actual.size() ? long(actual[i] - base) : -1;
+        if (e != a) {
+            fprintf(stderr, "  第 %zu 个: 暴力 +%ld，实际 +%ld\n", i, e, a);
+            break;
+        }
+    }
+}
+
+int main(int argc, char** argv) {
+    size_t rounds = argc > 1 ? strtoull(argv[1], nullptr, 10) : 2000;
+    Random random{argc > 2 ? strtoull(argv[2], nullptr, 10) | 1 : 0x2545F4914F6CDD1Dull};
+
+    // 前半段低熵（少数几个字节值，匹配密集），后半段是均匀随机字节；
+    // 大于 parallelScan 的最小分块（256KB），保证会切成多块并跨块匹配
+    std::vector<uint8_t> data(3 * 1024 * 1024 + 123);
+    for (size_t i = 0; i < data.size(); i++) {
+        data[i] = i < data.size() / 2 ? uint8_t(random.below(4) * 0x3F) : uint8_t(random.next());
+    }
+
+    size_t failures = 0, total_matches = 0;
+    std::vector<uint8_t> bytes, mask;
+    for (size_t round = 0; round < rounds && failures < 10; round++) {
+        std::string text = randomPattern(random, data, &bytes, &mask);
+        std::optional<BytePattern> pattern = BytePattern::compile(text);
+        if (!pattern) {
+            fprintf(stderr, "✗ 模式编译失败: \"%s\"\n", text.c_str());
+            failures++;
+            continue;
+        }
+
+        // 多数轮次用小范围（覆盖各种非对齐起点与 SIMD 收尾），部分轮次用整块数据
+        size_t begin = random.below(4096);
+        size_t size = random.below(4) == 0 ? data.size() - begin : random.below(8192);
+        const uint8_t* range_begin = data.data() + begin;
+        const uint8_t* range_end = range_begin + size;
+
+        std::vector<const uint8_t*> expected = bruteForce(range_begin, range_end, bytes, mask);
+        total_matches += expected.size();
+
+        std::vector<const uint8_t*> scanned;
+        pattern->scan(range_begin, range_end, [&](const uint8_t* match) {
+            scanned.push_back(match);
+            return true;
+        });
+        if (scanned != expected) {
+            report("scan", text, begin, size, expected, scanned, data.data());
+            failures++;
+        }
+
+        std::vector<const uint8_t*> all = parallelScan(*pattern, range_begin, range_end, ScanMode::ALL);
+        if (all != expected) {
+            report("parallelScan(ALL)", text, begin, size, expected, all, data.data());
+            failures++;
+        }
+
+        std::vector<const uint8_t*> lowest = parallelScan(*pattern, range_begin, range_end, ScanMode::FIRST_LOWEST);
+        std::vector<const uint8_t*> expected_lowest;
+        if (!expected.empty()) expected_lowest.push_back(expected.front());
+        if (lowest != expected_lowest) {
+            report("parallelScan(FIRST_LOWEST)", text, begin, size, expected_lowest, lowest, data.data());
+            failures++;
+        }
+    }
+
+    printf("%zu 轮，暴力匹配共 %zu 个，不一致 %zu 处（SIMD=%d）\n", rounds, total_matches, failures, FG_SCAN_SIMD);
+    return failures == 0 ? 0 : 1;
+}
@@ -0,0 +1,162 @@
+// 捕获文件读取工具：列出 capture.fgc 中的记录，或按序号取出单条记录的内容
+//
+// 编译: g++ -std=c++17 -O2 -I jni tools/fgcap_read.cpp -o fgcap_read -lz
+// 用法: adb pull /sdcard/Android/data/<包名>/cache/capture.fgc
+//       ./fgcap_read capture.fgc            列出全部记录
+//       ./fgcap_read capture.fgc <序号>     输出该记录内容到 stdout（只解压所在的块）
+
+#include <cstdio>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <ctime>
+#include <string>
+#include <vector>
+
+#include <zlib.h>
+
+#include "capture_format.h"
+
+static const char* kindName(uint8_t kind) {
+    switch (kind) {
+        case CAPTURE_HTTP_REQUEST: return "request";
+        case CAPTURE_HTTP_RESPONSE: return "response";
+        case CAPTURE_LUA_CHUNK: return "lua";
+        case CAPTURE_EVAL_STRING: return "eval";
+        default: return "?";
+    }
+}
+
+static bool readAt(FILE* file, uint64_t offset, void* out, size_t size) {
+    return fseeko(file, off_t(offset), SEEK_SET) == 0 && fread(out, 1, size, file) == size;
+}
+
+// 优先读取索引尾；进程被杀导致 Trailer 无效时按块头顺序扫描
+static bool loadIndex(FILE* file, uint64_t file_size, std::vector<CaptureIndexEntry>* index) {
+    CaptureTrailer trailer;
+    if (file_size >= sizeof(CaptureFileHeader) + sizeof(trailer) &&
+        readAt(file, file_size - sizeof(trailer), &trailer, sizeof(trailer)) &&
+        trailer.magic == kCaptureTrailerMagic &&
+        trailer.index_offset + uint64_t(trailer.block_count) * sizeof(CaptureIndexEntry) + sizeof(trailer) ==
+            file_size) {
+        index->resize(trailer.block_count);
+        if (readAt(file, trailer.index_offset, index->data(), index->size() * sizeof(CaptureIndexEntry))) {
+            return true;
+        }
+    }
+
+    fprintf(stderr, "索引尾无效，按块头扫描\n");
+    index->clear();
+    uint64_t offset = sizeof(CaptureFileHeader);
+    CaptureBlockHeader header;
+    while (offset + sizeof(header) <= file_size && readAt(file, offset, &header, sizeof(header)) &&
+           header.magic == kCaptureBlockMagic && offset + sizeof(header) + header.compressed_size <= file_size) {
+        index->push_back({offset, header.first_record, header.record_count, 0});
+        offset += sizeof(header) + header.compressed_size;
+    }
+    return false;
+}
+
+static bool loadBlock(FILE* file, const CaptureIndexEntry& entry, std::vector<uint8_t>* data) {
+    CaptureBlockHeader header;
+    if (!readAt(file, entry.offset, &header, sizeof(header)) || header.magic != kCaptureBlockMagic) {
+        fprintf(stderr, "偏移 %llu 处块头无效\n", (unsigned long long)entry.offset);
+        return false;
+    }
+    std::vector<uint8_t> compressed(header.compressed_size);
+    if (!readAt(file, entry.offset + sizeof(header), compressed.data(), compressed.size())) {
+        fprintf(stderr, "偏移 %llu 处块数据不完整\n", (unsigned long long)entry.offset);
+        return false;
+    }
+    data->resize(header.uncompressed_size);
+    uLongf size = header.uncompressed_size;
+    if (uncompress(data->data(), &size, compressed.data(), compressed.size()) != Z_OK ||
+        size != header.uncompressed_size ||
+        crc32(0, data->data(), data->size()) != header.crc32) {
+        fprintf(stderr, "偏移 %llu 处块解压或校验失败\n", (unsigned long long)entry.offset);
+        return false;
+    }
+    return true;
+}
+
+static void formatTime(uint64_t timestamp_ns, char* out, size_t size) {
+    time_t seconds = time_t(timestamp_ns / 1000000000ull);
+    tm local = {};
+    localtime_r(&seconds, &local);
+    size_t n = strftime(out, size, "%m-%d %H:%M:%S", &local);
+    snprintf(out + n, size - n, ".%03u", unsigned(timestamp_ns / 1000000ull % 1000));
+}
+
+int main(int argc, char** argv) {
+    if (argc != 2 && argc != 3) {
+        fprintf(stderr, "用法: %s <capture.fgc> [序号]\n", argv[0]);
+        return 2;
+    }
+
+    FILE* file = fopen(argv[1], "rb");
+    if (!file) {
+        perror(argv[1]);
+        return 1;
+    }
+    CaptureFileHeader file_header;
+    if (!readAt(file, 0, &file_header, sizeof(file_header)) || file_header.magic != kCaptureFileMagic ||
+        file_header.version != kCaptureVersion) {
+        fprintf(stderr, "不是 v%u 捕获文件\n", kCaptureVersion);
+        return 1;
+    }
+    fseeko(file, 0, SEEK_END);
+    uint64_t file_size = uint64_t(ftello(file));
+
+    std::vector<CaptureIndexEntry> index;
+    loadIndex(file, file_size, &index);
+    std::vector<uint8_t> block;
+
+    if (argc == 3) {
+        uint64_t sequence = strtoull(argv[2], nullptr, 10);
+        // 索引按 first_record 递增，二分找到最后一个 first_record <= sequence 的块
+        size_t lo = 0, hi = index.size();
+        while (lo < hi) {
+            size_t mid = lo + (hi - lo) / 2;
+            if (index[mid].first_record <= sequence) lo = mid + 1;
+            else hi = mid;
+        }
+        if (lo == 0 || sequence >= index[lo - 1].first_record + index[lo - 1].record_count) {
+            fprintf(stderr, "记录 #%llu 不存在\n", (unsigned long long)sequence);
+            return 1;
+        }
+        const CaptureIndexEntry& entry = index[lo - 1];
+        if (!loadBlock(file, entry, &block)) {
+            return 1;
+        }
+        size_t offset = 0;
+        CaptureRecordView record;
+        for (uint64_t i = entry.first_record; nextCaptureRecord(block.data(), block.size(), &offset, &record); i++) {
+            if (i == sequence) {
+                fwrite(record.payload, 1, record.header.payload_length, stdout);
+                return 0;
+            }
+        }
+        fprintf(stderr, "块内记录不完整\n");
+        return 1;
+    }
+
+    char time_text[32];
+    uint64_t records = 0;
+    for (const CaptureIndexEntry& entry : index) {
+        if (!loadBlock(file, entry, &block)) {
+            continue;
+        }
+        size_t offset = 0;
+        CaptureRecordView record;
+        for (uint64_t i = entry.first_record; nextCaptureRecord(block.data(), block.size(), &offset, &record); i++) {
+            formatTime(record.header.timestamp_ns, time_text, sizeof(time_text));
+            printf("#%-8llu %s %-8s %8u  %.*s\n", (unsigned long long)i, time_text, kindName(record.header.kind),
+                   record.header.payload_length, int(record.header.name_length), record.name);
+            records++;
+        }
+    }
+    fclose(file);
+
+    fprintf(stderr, "共 %zu 块，%llu 条记录\n", index.size(), (unsigned long long)records);
+    return 0;
+}
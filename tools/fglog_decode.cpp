@@ -0,0 +1,169 @@
+// 二进制日志解码工具：把 FG_LOG_BINARY 生成的 log.bin 还原为文本
+//
+// 编译: g++ -std=c++17 -O2 -I jni tools/fglog_decode.cpp -o fglog_decode
+// 用法: adb pull /sdcard/Android/data/<包名>/cache/log.bin && ./fglog_decode log.bin
+//       （同应用的其他进程写的是 log.<pid>.bin，格式相同）
+
+#include <cstdio>
+#include <cstdint>
+#include <cstring>
+#include <ctime>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "log_record.h"
+
+// 顺序读取条目字段，越界时置为失败
+class EntryReader {
+public:
+    EntryReader(const uint8_t* begin, const uint8_t* end) : pos_(begin), end_(end) {}
+
+    template <typename T>
+    bool get(T& value) {
+        if (size_t(end_ - pos_) < sizeof(T)) {
+            return false;
+        }
+        memcpy(&value, pos_, sizeof(T));
+        pos_ += sizeof(T);
+        return true;
+    }
+
+    const uint8_t* take(size_t size) {
+        if (size_t(end_ - pos_) < size) {
+            return nullptr;
+        }
+        const uint8_t* data = pos_;
+        pos_ += size;
+        return data;
+    }
+
+    bool done() const { return pos_ >= end_; }
+    size_t offset(const uint8_t* base) const { return pos_ - base; }
+
+private:
+    const uint8_t* pos_;
+    const uint8_t* end_;
+};
+
+static char priorityLetter(uint8_t priority) {
+    switch (priority) {
+        case 2: return 'V';
+        case 3: return 'D';
+        case 4: return 'I';
+        case 5: return 'W';
+        case 6: return 'E';
+        case 7: return 'F';
+        default: return '?';
+    }
+}
+
+// 把单调时钟时间戳换算为本地时间 "MM-DD HH:MM:SS.mmm"（与 logcat 一致）
+static void formatTime(const LogFileHeader& header, uint64_t timestamp_ns, char* out, size_t size) {
+    uint64_t realtime_ns = header.realtime_ns + (timestamp_ns - header.monotonic_ns);
+    time_t seconds = time_t(realtime_ns / 1000000000ull);
+    tm local = {};
+    localtime_r(&seconds, &local);
+    size_t n = strftime(out, size, "%m-%d %H:%M:%S", &local);
+    snprintf(out + n, size - n, ".%03u", unsigned(realtime_ns / 1000000ull % 1000));
+}
+
+int main(int argc, char** argv) {
+    if (argc != 2) {
+        fprintf(stderr, "用法: %s <log.bin>\n", argv[0]);
+        return 2;
+    }
+
+    FILE* file = fopen(argv[1], "rb");
+    if (!file) {
+        perror(argv[1]);
+        return 1;
+    }
+    std::vector<uint8_t> data;
+    uint8_t chunk[65536];
+    size_t n;
+    while ((n = fread(chunk, 1, sizeof(chunk), file)) > 0) {
+        data.insert(data.end(), chunk, chunk + n);
+    }
+    fclose(file);
+
+    LogFileHeader header;
+    if (data.size() < sizeof(header)) {
+        fprintf(stderr, "文件过短\n");
+        return 1;
+    }
+    memcpy(&header, data.data(), sizeof(header));
+    if (header.magic != kLogFileMagic || header.version != kLogFileVersion) {
+        fprintf(stderr, "不是 v%u 二进制日志 (magic=0x%08x version=%u)\n",
+                kLogFileVersion, header.magic, header.version);
+        return 1;
+    }
+
+    const uint8_t* base = data.data();
+    EntryReader reader(base + sizeof(header), base + data.size());
+    std::unordered_map<uint32_t, std::string> formats;
+    char text[kLogMaxRecordSize];
+    char time_text[32];
+    size_t records = 0;
+
+    while (!reader.done()) {
+        size_t entry_offset = reader.offset(base);
+        uint8_t type = 0;
+        reader.get(type);
+
+        bool ok = false;
+        switch (type) {
+            case LOG_ENTRY_FORMAT: {
+                uint32_t id;
+                uint16_t length;
+                const uint8_t* chars;
+                if (reader.get(id) && reader.get(length) && (chars = reader.take(length))) {
+                    formats[id].assign(reinterpret_cast<const char*>(chars), length);
+                    ok = true;
+                }
+                break;
+            }
+            case LOG_ENTRY_RECORD: {
+                uint32_t id, tid;
+                uint8_t priority;
+                uint64_t timestamp_ns;
+                uint16_t args_size;
+                const uint8_t* args;
+                if (reader.get(id) && reader.get(priority) && reader.get(tid) && reader.get(timestamp_ns) &&
+                    reader.get(args_size) && (args = reader.take(args_size))) {
+                    auto it = formats.find(id);
+                    if (it != formats.end()) {
+                        formatLogArgs(it->second.c_str(), args, args + args_size, text, sizeof(text));
+                    } else {
+                        snprintf(text, sizeof(text), "<未定义的格式串 #%u>", id);
+                    }
+                    formatTime(header, timestamp_ns, time_text, sizeof(time_text));
+                    printf("%s %5u %c %s\n", time_text, tid, priorityLetter(priority), text);
+                    records++;
+                    ok = true;
+                }
+                break;
+            }
+            case LOG_ENTRY_DROPPED: {
+                uint32_t tid;
+                uint64_t count;
+                if (reader.get(tid) && reader.get(count)) {
+                    printf("---------- %5u 丢弃 %llu 条记录\n", tid, (unsigned long long)count);
+                    ok = true;
+                }
+                break;
+            }
+            default:
+                break;
+        }
+
+        if (!ok) {
+            // 进程被杀时文件尾可能只写了一半
+            fprintf(stderr, "偏移 %zu 处的条目不完整或类型未知 (%u)，停止解码\n", entry_offset, type);
+            break;
+        }
+    }
+
+    fprintf(stderr, "共 %zu 条记录，%zu 个格式串\n", records, formats.size());
+    return 0;
+}
@@ -0,0 +1,50 @@
+// 基准工具共用的旧 maps 解析（优化前 jni/main.cpp 的 parseMaps，去掉日志与计时）与夹具写出
+// tools/bench_maps.cpp 与 tools/bench_discovery.cpp 共用，只依赖标准库
+
+#pragma once
+
+#include <cstdio>
+#include <fstream>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+
+using LibraryMap = std::unordered_map<std::string, std::string>;
+
+inline std::string extractLibraryName(const std::string& path) {
+    size_t last_slash = path.rfind('/');
+    if (last_slash == std::string::npos) return path;
+    return path.substr(last_slash + 1);
+}
+
+inline LibraryMap legacyParseMaps(const char* maps_path) {
+    LibraryMap library_map;
+    std::ifstream maps_file(maps_path);
+    if (!maps_file.is_open()) {
+        return library_map;
+    }
+    std::string line;
+    while (std::getline(maps_file, line)) {
+        if (line.find("data/") != std::string::npos) {
+            size_t path_start = line.rfind(' ');
+            if (path_start != std::string::npos) {
+                std::string full_path = line.substr(path_start + 1);
+                std::string lib_name = extractLibraryName(full_path);
+                if (lib_name.find(".so") != std::string::npos || lib_name.find("base.apk") != std::string::npos) {
+                    library_map[lib_name] = full_path;
+                }
+            }
+        }
+    }
+    return library_map;
+}
+
+inline bool writeFile(const std::string& path, std::string_view content) {
+    FILE* file = fopen(path.c_str(), "wb");
+    if (!file) {
+        perror(path.c_str());
+        return false;
+    }
+    bool ok = fwrite(content.data(), 1, content.size(), file) == content.size();
+    return fclose(file) == 0 && ok;
+}